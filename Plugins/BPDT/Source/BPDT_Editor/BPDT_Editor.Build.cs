@@ -15,7 +15,8 @@ public class BPDT_Editor : ModuleRules
             "Blutility",
             "EditorScriptingUtilities",
             "AssetRegistry",
-            "ToolMenus"
+            "ToolMenus",
+            "BPDT_Runtime"
         });
 
         PrivateDependencyModuleNames.AddRange(new string[]
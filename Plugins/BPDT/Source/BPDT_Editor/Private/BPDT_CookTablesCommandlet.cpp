@@ -0,0 +1,34 @@
+#include "BPDT_CookTablesCommandlet.h"
+
+#include "BPDT_TableManager.h"
+#include "BPDT_CookedTables.h"
+
+UBPDT_CookTablesCommandlet::UBPDT_CookTablesCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+}
+
+int32 UBPDT_CookTablesCommandlet::Main(const FString& Params)
+{
+    if (!UBPDT_TableManager::LoadAllTables())
+    {
+        UE_LOG(LogTemp, Error, TEXT("[BPDT_Editor] CookTables: could not load the saved tables."));
+        return 1;
+    }
+
+    const TSharedRef<const FBPDT_DatabaseSnapshot> Snapshot = UBPDT_TableManager::TakeSnapshot();
+    const FString Path = FBPDT_CookedTables::GetCookedPath();
+
+    if (!FBPDT_CookedTables::Write(Path, Snapshot->Tables, Snapshot->ForeignKeys))
+    {
+        UE_LOG(LogTemp, Error, TEXT("[BPDT_Editor] CookTables: failed to write %s"), *Path);
+        return 1;
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("[BPDT_Editor] CookTables: %d tables -> %s"),
+        Snapshot->Tables.Num(), *Path);
+    return 0;
+}
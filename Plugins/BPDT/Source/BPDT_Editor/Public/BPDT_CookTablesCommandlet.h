@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "BPDT_CookTablesCommandlet.generated.h"
+
+/**
+ * Writes every saved table into the cooked read-only file that packaged
+ * builds mount (Content/BPDT/Cooked). Run before packaging:
+ *   UnrealEditor-Cmd <Project>.uproject -run=BPDT_CookTables
+ */
+UCLASS()
+class UBPDT_CookTablesCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UBPDT_CookTablesCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
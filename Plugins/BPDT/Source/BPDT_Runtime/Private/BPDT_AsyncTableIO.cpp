@@ -0,0 +1,81 @@
+#include "BPDT_AsyncTableIO.h"
+#include "BPDT_TableManager.h"
+#include "Async/Async.h"
+
+UBPDT_AsyncTableIO* UBPDT_AsyncTableIO::SaveTableAsync(UObject* WorldContextObject, const FString& TableName)
+{
+	return Create(WorldContextObject, EOperation::SaveTable, TableName);
+}
+
+UBPDT_AsyncTableIO* UBPDT_AsyncTableIO::SaveAllTablesAsync(UObject* WorldContextObject)
+{
+	return Create(WorldContextObject, EOperation::SaveAllTables, FString());
+}
+
+UBPDT_AsyncTableIO* UBPDT_AsyncTableIO::LoadTableAsync(UObject* WorldContextObject, const FString& TableName)
+{
+	return Create(WorldContextObject, EOperation::LoadTable, TableName);
+}
+
+UBPDT_AsyncTableIO* UBPDT_AsyncTableIO::LoadAllTablesAsync(UObject* WorldContextObject)
+{
+	return Create(WorldContextObject, EOperation::LoadAllTables, FString());
+}
+
+UBPDT_AsyncTableIO* UBPDT_AsyncTableIO::Create(
+	UObject* WorldContextObject,
+	EOperation Operation,
+	const FString& TableName
+)
+{
+	UBPDT_AsyncTableIO* Action = NewObject<UBPDT_AsyncTableIO>();
+	Action->Operation = Operation;
+	Action->TableName = TableName;
+
+	// Keeps the action alive until SetReadyToDestroy
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UBPDT_AsyncTableIO::Activate()
+{
+	TFuture<bool> Future;
+
+	switch (Operation)
+	{
+	case EOperation::SaveTable:
+		Future = UBPDT_TableManager::SaveTableAsync(TableName);
+		break;
+
+	case EOperation::SaveAllTables:
+		Future = UBPDT_TableManager::SaveAllTablesAsync();
+		break;
+
+	case EOperation::LoadTable:
+		Future = UBPDT_TableManager::LoadTableAsync(TableName);
+		break;
+
+	case EOperation::LoadAllTables:
+		Future = UBPDT_TableManager::LoadAllTablesAsync();
+		break;
+	}
+
+	// Saves complete on a worker; the delegate must fire on the game thread
+	TWeakObjectPtr<UBPDT_AsyncTableIO> WeakThis(this);
+	Future.Next([WeakThis](bool bSuccess)
+	{
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, bSuccess]()
+		{
+			if (UBPDT_AsyncTableIO* This = WeakThis.Get())
+			{
+				This->Finish(bSuccess);
+			}
+		});
+	});
+}
+
+void UBPDT_AsyncTableIO::Finish(bool bSuccess)
+{
+	OnCompleted.Broadcast(bSuccess);
+	SetReadyToDestroy();
+}
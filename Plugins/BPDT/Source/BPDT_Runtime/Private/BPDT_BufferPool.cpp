@@ -0,0 +1,171 @@
+#include "BPDT_BufferPool.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+
+static TAutoConsoleVariable<int32> CVarBPDTBufferPoolMB(
+	TEXT("BPDT.BufferPoolMB"),
+	256,
+	TEXT("Lazy mode: memory budget in MB for pages of tables read without loading them. 0 loads the table instead."),
+	ECVF_Default
+);
+
+static FAutoConsoleCommand GBPDTBufferPoolStatsCommand(
+	TEXT("BPDT.BufferPool.Stats"),
+	TEXT("Logs size, hit rate and eviction counters of the table buffer pool."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		const FBPDT_BufferPoolStats Stats = FBPDT_BufferPool::Get().GetStats();
+		UE_LOG(LogTemp, Log,
+			TEXT("[BPDT] Buffer pool: %d pages, %.1f / %.1f MB, %lld hits, %lld misses (%.1f%%), %lld evictions."),
+			Stats.Pages,
+			Stats.UsedBytes / (1024.0 * 1024.0),
+			Stats.CapacityBytes / (1024.0 * 1024.0),
+			Stats.Hits,
+			Stats.Misses,
+			Stats.HitRate * 100.0f,
+			Stats.Evictions);
+	})
+);
+
+// Heap size of a page; an estimate good enough for the budget
+static int64 GetPageBytes(const FBPDT_Page& Page)
+{
+	int64 Bytes = Page.GetAllocatedSize();
+	for (const FBPDT_Cell& Cell : Page)
+	{
+		Bytes += Cell.Data.GetAllocatedSize();
+	}
+	return Bytes;
+}
+
+FBPDT_BufferPool& FBPDT_BufferPool::Get()
+{
+	static FBPDT_BufferPool Instance;
+	return Instance;
+}
+
+int64 FBPDT_BufferPool::GetCapacityBytes()
+{
+	return (int64)FMath::Max(CVarBPDTBufferPoolMB.GetValueOnAnyThread(), 0) * 1024 * 1024;
+}
+
+bool FBPDT_BufferPool::IsEnabled() const
+{
+	return GetCapacityBytes() > 0;
+}
+
+FBPDT_PageRef FBPDT_BufferPool::Find(const FBPDT_PageKey& Key)
+{
+	FScopeLock Lock(&Mutex);
+
+	const int32* Frame = FrameIndex.Find(Key);
+	if (!Frame)
+	{
+		++Misses;
+		return nullptr;
+	}
+
+	++Hits;
+	Frames[*Frame].bReferenced = true;
+	return Frames[*Frame].Page;
+}
+
+FBPDT_PageRef FBPDT_BufferPool::Add(const FBPDT_PageKey& Key, FBPDT_Page&& Page)
+{
+	const int64 Bytes = GetPageBytes(Page);
+	FBPDT_PageRef Ref = MakeShared<const FBPDT_Page, ESPMode::ThreadSafe>(MoveTemp(Page));
+
+	FScopeLock Lock(&Mutex);
+
+	if (const int32* Existing = FrameIndex.Find(Key))
+	{
+		return Frames[*Existing].Page;
+	}
+
+	// Shrinks with the budget too, when the CVar was lowered
+	const int64 Capacity = GetCapacityBytes();
+	EvictUntilFits(Bytes, Capacity);
+
+	if (Bytes > Capacity)
+	{
+		return Ref; // bigger than the whole pool: used once, not cached
+	}
+
+	int32 Index;
+	if (FreeFrames.Num() > 0)
+	{
+		Index = FreeFrames.Pop(EAllowShrinking::No);
+	}
+	else
+	{
+		Index = Frames.AddDefaulted();
+	}
+
+	FFrame& Frame = Frames[Index];
+	Frame.Key = Key;
+	Frame.Page = Ref;
+	Frame.Bytes = Bytes;
+	Frame.bReferenced = false;
+
+	FrameIndex.Add(Key, Index);
+	UsedBytes += Bytes;
+	return Ref;
+}
+
+void FBPDT_BufferPool::EvictUntilFits(int64 Bytes, int64 Capacity)
+{
+	while (UsedBytes + Bytes > Capacity && FrameIndex.Num() > 0)
+	{
+		const int32 Index = Hand;
+		Hand = (Hand + 1) % Frames.Num();
+
+		FFrame& Frame = Frames[Index];
+
+		if (!Frame.Page.IsValid())
+		{
+			continue;
+		}
+
+		// Second chance for pages used since the hand last passed
+		if (Frame.bReferenced)
+		{
+			Frame.bReferenced = false;
+			continue;
+		}
+
+		FrameIndex.Remove(Frame.Key);
+		UsedBytes -= Frame.Bytes;
+		++Evictions;
+
+		Frame = FFrame();
+		FreeFrames.Add(Index);
+	}
+}
+
+void FBPDT_BufferPool::Reset()
+{
+	FScopeLock Lock(&Mutex);
+
+	Frames.Reset();
+	FreeFrames.Reset();
+	FrameIndex.Reset();
+	Hand = 0;
+	UsedBytes = 0;
+}
+
+FBPDT_BufferPoolStats FBPDT_BufferPool::GetStats() const
+{
+	FScopeLock Lock(&Mutex);
+
+	FBPDT_BufferPoolStats Stats;
+	Stats.CapacityBytes = GetCapacityBytes();
+	Stats.UsedBytes = UsedBytes;
+	Stats.Pages = FrameIndex.Num();
+	Stats.Hits = Hits;
+	Stats.Misses = Misses;
+	Stats.Evictions = Evictions;
+
+	const int64 Lookups = Hits + Misses;
+	Stats.HitRate = Lookups > 0 ? (float)((double)Hits / Lookups) : 0.0f;
+	return Stats;
+}
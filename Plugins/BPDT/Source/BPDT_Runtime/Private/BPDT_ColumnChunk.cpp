@@ -0,0 +1,767 @@
+#include "BPDT_ColumnChunk.h"
+#include "Misc/Crc.h"
+
+/* ===================== BYTES / BITS ===================== */
+
+template<typename T>
+static void Put(TArray<uint8>& Out, T Value)
+{
+	Out.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+}
+
+// Bounds-checked cursor over one chunk
+struct FBPDT_ChunkReader
+{
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+	int64 Pos = 0;
+
+	const uint8* Take(int64 Bytes)
+	{
+		if (Bytes < 0 || Pos + Bytes > Size)
+		{
+			return nullptr;
+		}
+
+		const uint8* Ptr = Data + Pos;
+		Pos += Bytes;
+		return Ptr;
+	}
+
+	template<typename T>
+	bool Get(T& OutValue)
+	{
+		const uint8* Ptr = Take(sizeof(T));
+		if (!Ptr)
+		{
+			return false;
+		}
+
+		FMemory::Memcpy(&OutValue, Ptr, sizeof(T));
+		return true;
+	}
+};
+
+static int32 BitWidth(uint64 MaxValue)
+{
+	return MaxValue == 0 ? 0 : 64 - (int32)FPlatformMath::CountLeadingZeros64(MaxValue);
+}
+
+static int64 PackedBytes(int64 Count, int32 Width)
+{
+	return (Count * Width + 7) / 8;
+}
+
+// LSB first, values never straddle more than Width bits
+static void PackBits(TArray<uint8>& Out, const TArray<uint64>& Values, int32 Width)
+{
+	const int32 Start = Out.Num();
+	Out.AddZeroed((int32)PackedBytes(Values.Num(), Width));
+	uint8* Dst = Out.GetData() + Start;
+
+	int64 BitPos = 0;
+	for (const uint64 Value : Values)
+	{
+		for (int32 Done = 0; Done < Width; )
+		{
+			const int32 BitInByte = BitPos & 7;
+			const int32 Take = FMath::Min(8 - BitInByte, Width - Done);
+
+			Dst[BitPos >> 3] |= (uint8)(((Value >> Done) & ((1u << Take) - 1)) << BitInByte);
+
+			Done += Take;
+			BitPos += Take;
+		}
+	}
+}
+
+static uint64 UnpackBits(const uint8* Src, int64 Index, int32 Width)
+{
+	uint64 Value = 0;
+	int64 BitPos = Index * Width;
+
+	for (int32 Done = 0; Done < Width; )
+	{
+		const int32 BitInByte = BitPos & 7;
+		const int32 Take = FMath::Min(8 - BitInByte, Width - Done);
+
+		Value |= (uint64)((Src[BitPos >> 3] >> BitInByte) & ((1u << Take) - 1)) << Done;
+
+		Done += Take;
+		BitPos += Take;
+	}
+
+	return Value;
+}
+
+static FBPDT_Cell MakeStringCell(const uint8* Bytes, int32 Length)
+{
+	if (Length > 0)
+	{
+		return FBPDT_Cell(EBPDT_CellType::String, Bytes, Length);
+	}
+
+	// FBPDT_Cell's constructor rejects empty payloads
+	FBPDT_Cell Cell;
+	Cell.Type = EBPDT_CellType::String;
+	Cell.bIsNull = false;
+	return Cell;
+}
+
+/* ===================== ENCODE ===================== */
+
+static EBPDT_ChunkEncoding EncodeFixed(
+	EBPDT_CellType Type,
+	int32 Width,
+	const TArray<uint8>& Values,
+	int32 Count,
+	TArray<uint8>& Out
+)
+{
+	if (Count == 0)
+	{
+		return EBPDT_ChunkEncoding::Plain;
+	}
+
+	// ---- bools: always one bit per value ----
+	if (Type == EBPDT_CellType::Bool)
+	{
+		TArray<uint64> Bits;
+		Bits.SetNumUninitialized(Count);
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Bits[i] = Values[i * Width] != 0 ? 1 : 0;
+		}
+
+		PackBits(Out, Bits, 1);
+		return EBPDT_ChunkEncoding::BitPacked;
+	}
+
+	// ---- size every candidate ----
+	EBPDT_ChunkEncoding Best = EBPDT_ChunkEncoding::Plain;
+	int64 BestSize = Values.Num();
+
+	int32 Runs = 1;
+	for (int32 i = 1; i < Count; ++i)
+	{
+		if (FMemory::Memcmp(&Values[i * Width], &Values[(i - 1) * Width], Width) != 0)
+		{
+			++Runs;
+		}
+	}
+
+	const int64 RunLengthSize = sizeof(uint32) + (int64)Runs * (sizeof(uint32) + Width);
+	if (RunLengthSize < BestSize)
+	{
+		Best = EBPDT_ChunkEncoding::RunLength;
+		BestSize = RunLengthSize;
+	}
+
+	int32 Min = 0;
+	int32 ForWidth = 0;
+	int64 MinDelta = 0;
+	int32 DeltaWidth = 0;
+
+	TArray<int32> Ints;
+	if (Type == EBPDT_CellType::Int && Width == sizeof(int32))
+	{
+		Ints.SetNumUninitialized(Count);
+		FMemory::Memcpy(Ints.GetData(), Values.GetData(), Count * sizeof(int32));
+
+		int32 Max = Ints[0];
+		Min = Ints[0];
+		for (const int32 V : Ints)
+		{
+			Min = FMath::Min(Min, V);
+			Max = FMath::Max(Max, V);
+		}
+
+		ForWidth = BitWidth((uint64)((int64)Max - Min));
+		const int64 ForSize = sizeof(int32) + sizeof(uint8) + PackedBytes(Count, ForWidth);
+		if (ForSize < BestSize)
+		{
+			Best = EBPDT_ChunkEncoding::FrameOfReference;
+			BestSize = ForSize;
+		}
+
+		if (Count > 1)
+		{
+			int64 MaxDelta = (int64)Ints[1] - Ints[0];
+			MinDelta = MaxDelta;
+			for (int32 i = 2; i < Count; ++i)
+			{
+				const int64 D = (int64)Ints[i] - Ints[i - 1];
+				MinDelta = FMath::Min(MinDelta, D);
+				MaxDelta = FMath::Max(MaxDelta, D);
+			}
+
+			DeltaWidth = BitWidth((uint64)(MaxDelta - MinDelta));
+			const int64 DeltaSize =
+				sizeof(int32) + sizeof(int64) + sizeof(uint8) + PackedBytes(Count - 1, DeltaWidth);
+
+			if (DeltaSize < BestSize)
+			{
+				Best = EBPDT_ChunkEncoding::Delta;
+				BestSize = DeltaSize;
+			}
+		}
+	}
+
+	// ---- emit the winner ----
+	switch (Best)
+	{
+	case EBPDT_ChunkEncoding::RunLength:
+	{
+		Put<uint32>(Out, (uint32)Runs);
+
+		int32 RunStart = 0;
+		for (int32 i = 1; i <= Count; ++i)
+		{
+			if (i == Count ||
+				FMemory::Memcmp(&Values[i * Width], &Values[RunStart * Width], Width) != 0)
+			{
+				Put<uint32>(Out, (uint32)(i - RunStart));
+				Out.Append(&Values[RunStart * Width], Width);
+				RunStart = i;
+			}
+		}
+		break;
+	}
+
+	case EBPDT_ChunkEncoding::FrameOfReference:
+	{
+		Put<int32>(Out, Min);
+		Put<uint8>(Out, (uint8)ForWidth);
+
+		TArray<uint64> Packed;
+		Packed.SetNumUninitialized(Count);
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Packed[i] = (uint64)((int64)Ints[i] - Min);
+		}
+		PackBits(Out, Packed, ForWidth);
+		break;
+	}
+
+	case EBPDT_ChunkEncoding::Delta:
+	{
+		Put<int32>(Out, Ints[0]);
+		Put<int64>(Out, MinDelta);
+		Put<uint8>(Out, (uint8)DeltaWidth);
+
+		TArray<uint64> Packed;
+		Packed.SetNumUninitialized(Count - 1);
+		for (int32 i = 1; i < Count; ++i)
+		{
+			Packed[i - 1] = (uint64)(((int64)Ints[i] - Ints[i - 1]) - MinDelta);
+		}
+		PackBits(Out, Packed, DeltaWidth);
+		break;
+	}
+
+	default:
+		Out.Append(Values);
+		break;
+	}
+
+	return Best;
+}
+
+/*
+ * String heap: uint32 blob size, uint8 offset width, the end offset of every
+ * value packed to that width, then all values back to back as one UTF-8 blob.
+ * A reader validates the offsets once and slices the blob; no per-value
+ * length prefixes to chase.
+ */
+
+static int64 StringHeapSize(int64 Count, int64 BlobBytes)
+{
+	return sizeof(uint32) + sizeof(uint8) + PackedBytes(Count, BitWidth((uint64)BlobBytes)) + BlobBytes;
+}
+
+static void WriteStringHeap(TArray<uint8>& Out, const TArray<const FBPDT_Cell*>& Values)
+{
+	TArray<uint64> Ends;
+	Ends.SetNumUninitialized(Values.Num());
+
+	uint64 BlobBytes = 0;
+	for (int32 i = 0; i < Values.Num(); ++i)
+	{
+		BlobBytes += Values[i]->Data.Num();
+		Ends[i] = BlobBytes;
+	}
+
+	const int32 OffsetWidth = BitWidth(BlobBytes);
+
+	Put<uint32>(Out, (uint32)BlobBytes);
+	Put<uint8>(Out, (uint8)OffsetWidth);
+	PackBits(Out, Ends, OffsetWidth);
+
+	Out.Reserve(Out.Num() + (int32)BlobBytes);
+	for (const FBPDT_Cell* Cell : Values)
+	{
+		Out.Append(Cell->Data);
+	}
+}
+
+static EBPDT_ChunkEncoding EncodeStrings(
+	const TArray<const FBPDT_Cell*>& Values,
+	TArray<uint8>& Out
+)
+{
+	int64 BlobBytes = 0;
+
+	// ---- distinct values, bucketed by CRC ----
+	TMultiMap<uint32, int32> ByHash;
+	TArray<const FBPDT_Cell*> Dictionary;
+	TArray<uint64> Indices;
+	Indices.Reserve(Values.Num());
+
+	int64 DictionaryBlobBytes = 0;
+
+	for (const FBPDT_Cell* Cell : Values)
+	{
+		BlobBytes += Cell->Data.Num();
+
+		const uint32 Crc = FCrc::MemCrc32(Cell->Data.GetData(), Cell->Data.Num());
+
+		int32 Found = INDEX_NONE;
+		for (auto It = ByHash.CreateConstKeyIterator(Crc); It; ++It)
+		{
+			if (Dictionary[It.Value()]->Data == Cell->Data)
+			{
+				Found = It.Value();
+				break;
+			}
+		}
+
+		if (Found == INDEX_NONE)
+		{
+			Found = Dictionary.Add(Cell);
+			ByHash.Add(Crc, Found);
+			DictionaryBlobBytes += Cell->Data.Num();
+		}
+
+		Indices.Add((uint64)Found);
+	}
+
+	const int32 IndexWidth = BitWidth(Dictionary.Num() > 0 ? Dictionary.Num() - 1 : 0);
+
+	const int64 HeapSize = StringHeapSize(Values.Num(), BlobBytes);
+	const int64 DictionarySize =
+		sizeof(uint32) + StringHeapSize(Dictionary.Num(), DictionaryBlobBytes) +
+		sizeof(uint8) + PackedBytes(Values.Num(), IndexWidth);
+
+	if (Values.Num() > 0 && DictionarySize < HeapSize)
+	{
+		Put<uint32>(Out, (uint32)Dictionary.Num());
+		WriteStringHeap(Out, Dictionary);
+
+		Put<uint8>(Out, (uint8)IndexWidth);
+		PackBits(Out, Indices, IndexWidth);
+		return EBPDT_ChunkEncoding::HeapDictionary;
+	}
+
+	WriteStringHeap(Out, Values);
+	return EBPDT_ChunkEncoding::StringHeap;
+}
+
+void FBPDT_ColumnChunk::Encode(
+	EBPDT_CellType Type,
+	int32 ByteSize,
+	int32 RowCount,
+	TFunctionRef<const FBPDT_Cell& (int32 RowInChunk)> GetCell,
+	TArray<uint8>& Out
+)
+{
+	// ---- split nulls from values ----
+	TArray<uint8> NullBitmap;
+	NullBitmap.SetNumZeroed((RowCount + 7) / 8);
+
+	uint32 NullCount = 0;
+	TArray<const FBPDT_Cell*> Values;
+	Values.Reserve(RowCount);
+
+	for (int32 Row = 0; Row < RowCount; ++Row)
+	{
+		const FBPDT_Cell& Cell = GetCell(Row);
+		if (Cell.bIsNull)
+		{
+			NullBitmap[Row / 8] |= (1 << (Row % 8));
+			++NullCount;
+		}
+		else
+		{
+			Values.Add(&Cell);
+		}
+	}
+
+	TArray<uint8> Payload;
+	EBPDT_ChunkEncoding Encoding;
+
+	if (Type == EBPDT_CellType::String)
+	{
+		Encoding = EncodeStrings(Values, Payload);
+	}
+	else
+	{
+		// Cells of the wrong size are stored zeroed, as the v1 format did
+		TArray<uint8> Fixed;
+		Fixed.SetNumZeroed(Values.Num() * ByteSize);
+
+		for (int32 i = 0; i < Values.Num(); ++i)
+		{
+			if (Values[i]->Data.Num() == ByteSize)
+			{
+				FMemory::Memcpy(&Fixed[i * ByteSize], Values[i]->Data.GetData(), ByteSize);
+			}
+		}
+
+		Encoding = EncodeFixed(Type, ByteSize, Fixed, Values.Num(), Payload);
+	}
+
+	FBPDT_ChunkHeader Header;
+	Header.Encoding = (uint8)Encoding;
+	Header.CellType = (uint8)Type;
+	Header.RowCount = (uint32)RowCount;
+	Header.NullCount = NullCount;
+	Header.PayloadBytes = (uint32)((NullCount > 0 ? NullBitmap.Num() : 0) + Payload.Num());
+
+	Out.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+	if (NullCount > 0)
+	{
+		Out.Append(NullBitmap);
+	}
+	Out.Append(Payload);
+}
+
+/* ===================== DECODE ===================== */
+
+static bool DecodeFixed(
+	FBPDT_ChunkReader& Reader,
+	EBPDT_ChunkEncoding Encoding,
+	EBPDT_CellType Type,
+	int32 Width,
+	int32 Count,
+	TArray<uint8>& OutValues
+)
+{
+	OutValues.SetNumZeroed(Count * Width);
+
+	const bool bInt = Type == EBPDT_CellType::Int && Width == sizeof(int32);
+
+	switch (Encoding)
+	{
+	case EBPDT_ChunkEncoding::Plain:
+	{
+		const uint8* Src = Reader.Take((int64)Count * Width);
+		if (!Src)
+		{
+			return false;
+		}
+		FMemory::Memcpy(OutValues.GetData(), Src, (int64)Count * Width);
+		return true;
+	}
+
+	case EBPDT_ChunkEncoding::BitPacked:
+	{
+		const uint8* Src = Reader.Take(PackedBytes(Count, 1));
+		if (Type != EBPDT_CellType::Bool || !Src)
+		{
+			return false;
+		}
+		for (int32 i = 0; i < Count; ++i)
+		{
+			OutValues[i * Width] = (uint8)UnpackBits(Src, i, 1);
+		}
+		return true;
+	}
+
+	case EBPDT_ChunkEncoding::FrameOfReference:
+	{
+		int32 Min = 0;
+		uint8 BitCount = 0;
+		if (!bInt || !Reader.Get(Min) || !Reader.Get(BitCount) || BitCount > 64)
+		{
+			return false;
+		}
+
+		const uint8* Src = Reader.Take(PackedBytes(Count, BitCount));
+		if (!Src)
+		{
+			return false;
+		}
+
+		int32* Dst = reinterpret_cast<int32*>(OutValues.GetData());
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Dst[i] = (int32)((int64)Min + (int64)UnpackBits(Src, i, BitCount));
+		}
+		return true;
+	}
+
+	case EBPDT_ChunkEncoding::Delta:
+	{
+		int32 First = 0;
+		int64 MinDelta = 0;
+		uint8 BitCount = 0;
+		if (!bInt || Count == 0 ||
+			!Reader.Get(First) || !Reader.Get(MinDelta) || !Reader.Get(BitCount) || BitCount > 64)
+		{
+			return false;
+		}
+
+		const uint8* Src = Reader.Take(PackedBytes(Count - 1, BitCount));
+		if (!Src)
+		{
+			return false;
+		}
+
+		int32* Dst = reinterpret_cast<int32*>(OutValues.GetData());
+		int64 Value = First;
+		Dst[0] = First;
+		for (int32 i = 1; i < Count; ++i)
+		{
+			Value += MinDelta + (int64)UnpackBits(Src, i - 1, BitCount);
+			Dst[i] = (int32)Value;
+		}
+		return true;
+	}
+
+	case EBPDT_ChunkEncoding::RunLength:
+	{
+		uint32 Runs = 0;
+		if (!Reader.Get(Runs))
+		{
+			return false;
+		}
+
+		int32 Written = 0;
+		for (uint32 Run = 0; Run < Runs; ++Run)
+		{
+			uint32 Length = 0;
+			if (!Reader.Get(Length))
+			{
+				return false;
+			}
+
+			const uint8* Value = Reader.Take(Width);
+			if (!Value || (int64)Written + Length > Count)
+			{
+				return false;
+			}
+
+			for (uint32 i = 0; i < Length; ++i)
+			{
+				FMemory::Memcpy(&OutValues[(Written + i) * Width], Value, Width);
+			}
+			Written += Length;
+		}
+		return Written == Count;
+	}
+
+	default:
+		return false;
+	}
+}
+
+// Slices of a string heap holding Count values
+static bool ReadStringHeap(
+	FBPDT_ChunkReader& Reader,
+	int32 Count,
+	TArray<TPair<const uint8*, int32>>& OutValues
+)
+{
+	uint32 BlobBytes = 0;
+	uint8 OffsetWidth = 0;
+	if (!Reader.Get(BlobBytes) || !Reader.Get(OffsetWidth) || OffsetWidth > 32)
+	{
+		return false;
+	}
+
+	const uint8* Ends = Reader.Take(PackedBytes(Count, OffsetWidth));
+	const uint8* Blob = Reader.Take(BlobBytes);
+	if (!Ends || !Blob)
+	{
+		return false;
+	}
+
+	OutValues.Reserve(OutValues.Num() + Count);
+
+	uint64 Start = 0;
+	for (int32 i = 0; i < Count; ++i)
+	{
+		const uint64 End = UnpackBits(Ends, i, OffsetWidth);
+		if (End < Start || End > BlobBytes)
+		{
+			return false;
+		}
+
+		OutValues.Emplace(Blob + Start, (int32)(End - Start));
+		Start = End;
+	}
+	return true;
+}
+
+// Views into the chunk: (bytes, length) per value
+static bool DecodeStrings(
+	FBPDT_ChunkReader& Reader,
+	EBPDT_ChunkEncoding Encoding,
+	int32 Count,
+	TArray<TPair<const uint8*, int32>>& OutValues
+)
+{
+	OutValues.Reserve(Count);
+
+	switch (Encoding)
+	{
+	case EBPDT_ChunkEncoding::StringHeap:
+		return ReadStringHeap(Reader, Count, OutValues);
+
+	case EBPDT_ChunkEncoding::HeapDictionary:
+		break;
+
+	default:
+		return false;
+	}
+
+	uint32 DictionaryCount = 0;
+	TArray<TPair<const uint8*, int32>> Dictionary;
+	if (!Reader.Get(DictionaryCount) ||
+		!ReadStringHeap(Reader, (int32)DictionaryCount, Dictionary))
+	{
+		return false;
+	}
+
+	uint8 IndexWidth = 0;
+	if (!Reader.Get(IndexWidth) || IndexWidth > 32)
+	{
+		return false;
+	}
+
+	const uint8* Src = Reader.Take(PackedBytes(Count, IndexWidth));
+	if (!Src)
+	{
+		return false;
+	}
+
+	for (int32 i = 0; i < Count; ++i)
+	{
+		const uint64 Index = UnpackBits(Src, i, IndexWidth);
+		if (Index >= DictionaryCount)
+		{
+			return false;
+		}
+		OutValues.Add(Dictionary[Index]);
+	}
+	return true;
+}
+
+bool FBPDT_ColumnChunk::Decode(
+	const uint8* Data,
+	int64 Size,
+	EBPDT_CellType Type,
+	int32 ByteSize,
+	TFunctionRef<void(int32 RowInChunk, FBPDT_Cell&& Cell)> Emit
+)
+{
+	FBPDT_ChunkReader Reader{ Data, Size };
+
+	FBPDT_ChunkHeader Header;
+	if (!Reader.Get(Header) || Header.CellType != (uint8)Type)
+	{
+		return false;
+	}
+
+	// Never read past this chunk
+	if ((int64)Header.PayloadBytes > Size - (int64)sizeof(Header))
+	{
+		return false;
+	}
+	Reader.Size = sizeof(Header) + (int64)Header.PayloadBytes;
+
+	const int32 RowCount = (int32)Header.RowCount;
+	if (Header.NullCount > Header.RowCount)
+	{
+		return false;
+	}
+
+	// ---- null bitmap ----
+	const uint8* NullBitmap = nullptr;
+	if (Header.NullCount > 0)
+	{
+		NullBitmap = Reader.Take((RowCount + 7) / 8);
+		if (!NullBitmap)
+		{
+			return false;
+		}
+
+		uint32 BitmapNulls = 0;
+		for (int32 Row = 0; Row < RowCount; ++Row)
+		{
+			BitmapNulls += (NullBitmap[Row / 8] >> (Row % 8)) & 1;
+		}
+		if (BitmapNulls != Header.NullCount)
+		{
+			return false;
+		}
+	}
+
+	auto IsNull = [NullBitmap](int32 Row)
+	{
+		return NullBitmap && (NullBitmap[Row / 8] & (1 << (Row % 8))) != 0;
+	};
+
+	const int32 ValueCount = RowCount - (int32)Header.NullCount;
+	const EBPDT_ChunkEncoding Encoding = (EBPDT_ChunkEncoding)Header.Encoding;
+
+	// ---- values, then rows ----
+	if (Type == EBPDT_CellType::String)
+	{
+		TArray<TPair<const uint8*, int32>> Values;
+		if (!DecodeStrings(Reader, Encoding, ValueCount, Values))
+		{
+			return false;
+		}
+
+		int32 Next = 0;
+		for (int32 Row = 0; Row < RowCount; ++Row)
+		{
+			if (IsNull(Row))
+			{
+				Emit(Row, FBPDT_Cell::MakeNull(Type));
+			}
+			else
+			{
+				const TPair<const uint8*, int32>& Value = Values[Next++];
+				Emit(Row, MakeStringCell(Value.Key, Value.Value));
+			}
+		}
+		return true;
+	}
+
+	if (ByteSize <= 0)
+	{
+		return false;
+	}
+
+	TArray<uint8> Values;
+	if (!DecodeFixed(Reader, Encoding, Type, ByteSize, ValueCount, Values))
+	{
+		return false;
+	}
+
+	int32 Next = 0;
+	for (int32 Row = 0; Row < RowCount; ++Row)
+	{
+		if (IsNull(Row))
+		{
+			Emit(Row, FBPDT_Cell::MakeNull(Type));
+		}
+		else
+		{
+			Emit(Row, FBPDT_Cell(Type, &Values[Next++ * ByteSize], ByteSize));
+		}
+	}
+	return true;
+}
@@ -0,0 +1,362 @@
+#include "BPDT_CommandBuffer.h"
+#include "BPDT_TableManager.h"
+#include "Misc/CoreDelegates.h"
+
+FBPDT_CommandBuffer& FBPDT_CommandBuffer::Get()
+{
+	static FBPDT_CommandBuffer Instance;
+	return Instance;
+}
+
+/* ===================== PRODUCERS ===================== */
+
+void FBPDT_CommandBuffer::Enqueue(FBPDT_Command&& Command)
+{
+	Command.Sequence = NextSequence.fetch_add(1, std::memory_order_relaxed);
+	Queue.Enqueue(MoveTemp(Command));
+}
+
+void FBPDT_CommandBuffer::EnqueueSetCell(
+	const FString& TableName,
+	const FString& PKValue,
+	FName ColumnName,
+	const FBPDT_Cell& Cell
+)
+{
+	FBPDT_Command Command;
+	Command.Type = EBPDT_CommandType::SetCell;
+	Command.TableName = TableName;
+	Command.PKValue = PKValue;
+	Command.ColumnName = ColumnName;
+	Command.Cell = Cell;
+
+	Enqueue(MoveTemp(Command));
+}
+
+void FBPDT_CommandBuffer::EnqueueInsertRow(
+	const FString& TableName,
+	TArray<FBPDT_Cell> Cells
+)
+{
+	FBPDT_Command Command;
+	Command.Type = EBPDT_CommandType::InsertRow;
+	Command.TableName = TableName;
+	Command.RowCells = MoveTemp(Cells);
+
+	Enqueue(MoveTemp(Command));
+}
+
+void FBPDT_CommandBuffer::EnqueueChangePrimaryKey(
+	const FString& TableName,
+	const FString& OldPKValue,
+	const FString& NewPKValue
+)
+{
+	FBPDT_Command Command;
+	Command.Type = EBPDT_CommandType::ChangePrimaryKey;
+	Command.TableName = TableName;
+	Command.PKValue = OldPKValue;
+	Command.NewPKValue = NewPKValue;
+
+	Enqueue(MoveTemp(Command));
+}
+
+/* ===================== FLUSH ===================== */
+
+int32 FBPDT_CommandBuffer::Flush()
+{
+	check(IsInGameThread());
+
+	TArray<FBPDT_Command> Pending;
+	FBPDT_Command Command;
+	while (Queue.Dequeue(Command))
+	{
+		Pending.Add(MoveTemp(Command));
+	}
+
+	if (Pending.Num() == 0)
+	{
+		return 0;
+	}
+
+	// Producers may be preempted between taking a sequence number and
+	// enqueuing; restore the global order first.
+	Pending.Sort(
+		[](const FBPDT_Command& A, const FBPDT_Command& B)
+		{
+			return A.Sequence < B.Sequence;
+		}
+	);
+
+	// ---- group per table (order inside a group is preserved) ----
+	TMap<FString, TArray<int32>> ByTable;
+	for (int32 i = 0; i < Pending.Num(); ++i)
+	{
+		ByTable.FindOrAdd(Pending[i].TableName).Add(i);
+	}
+
+	int32 Applied = 0;
+	for (const auto& Pair : ByTable)
+	{
+		Applied += ApplyTableCommands(Pair.Key, Pending, Pair.Value);
+	}
+
+	UE_LOG(LogTemp, Verbose,
+		TEXT("[BPDT] Command buffer flushed: %d queued, %d applied, %d tables"),
+		Pending.Num(),
+		Applied,
+		ByTable.Num());
+
+	return Applied;
+}
+
+int32 FBPDT_CommandBuffer::ApplyTableCommands(
+	const FString& TableName,
+	TArray<FBPDT_Command>& Commands,
+	TArrayView<const int32> Indices
+)
+{
+	int32 Applied = 0;
+	int32 Cursor = 0;
+
+	while (Cursor < Indices.Num())
+	{
+		FBPDT_Command& First = Commands[Indices[Cursor]];
+
+		// ---- PK change: the cascade needs the map lock, go through the manager ----
+		if (First.Type == EBPDT_CommandType::ChangePrimaryKey)
+		{
+			if (UBPDT_TableManager::ChangePrimaryKey(TableName, First.PKValue, First.NewPKValue))
+			{
+				++Applied;
+			}
+			++Cursor;
+			continue;
+		}
+
+		// ---- run of SetCell / InsertRow up to the next PK change ----
+		int32 RunEnd = Cursor;
+		while (RunEnd < Indices.Num() &&
+			Commands[Indices[RunEnd]].Type != EBPDT_CommandType::ChangePrimaryKey)
+		{
+			++RunEnd;
+		}
+
+		FBPDT_TableWriteScope Table(TableName);
+		if (!Table)
+		{
+			UE_LOG(LogTemp, Warning,
+				TEXT("[BPDT] Dropping %d queued commands: table '%s' not found"),
+				RunEnd - Cursor,
+				*TableName);
+			Cursor = RunEnd;
+			continue;
+		}
+
+		while (Cursor < RunEnd)
+		{
+			if (Commands[Indices[Cursor]].Type == EBPDT_CommandType::InsertRow)
+			{
+				if (ApplyInsertRow(*Table, Commands[Indices[Cursor]]))
+				{
+					++Applied;
+				}
+				++Cursor;
+				continue;
+			}
+
+			// SetCell batch up to the next insert
+			int32 BatchEnd = Cursor;
+			while (BatchEnd < RunEnd &&
+				Commands[Indices[BatchEnd]].Type == EBPDT_CommandType::SetCell)
+			{
+				++BatchEnd;
+			}
+
+			Applied += ApplySetCellBatch(*Table, Commands, Indices.Slice(Cursor, BatchEnd - Cursor));
+			Cursor = BatchEnd;
+		}
+	}
+
+	return Applied;
+}
+
+int32 FBPDT_CommandBuffer::ApplySetCellBatch(
+	FBPDT_Table& Table,
+	TArray<FBPDT_Command>& Commands,
+	TArrayView<const int32> Indices
+)
+{
+	struct FCellWrite
+	{
+		int32 ColumnIndex;
+		int32 RowIndex;
+		int32 CommandIndex;
+	};
+
+	const int32 PKIndex = Table.GetColumnIndex(Table.GetPKColumnName());
+
+	// Lookups are amortized over the batch
+	TMap<FName, int32> ColumnCache;
+	TMap<FString, int32> RowCache;
+
+	// (row, column) -> slot in Writes
+	TMap<TPair<int32, int32>, int32> Latest;
+	TArray<FCellWrite> Writes;
+	Writes.Reserve(Indices.Num());
+
+	for (const int32 CommandIndex : Indices)
+	{
+		const FBPDT_Command& Command = Commands[CommandIndex];
+
+		int32* ColumnIndex = ColumnCache.Find(Command.ColumnName);
+		if (!ColumnIndex)
+		{
+			ColumnIndex = &ColumnCache.Add(Command.ColumnName, Table.GetColumnIndex(Command.ColumnName));
+		}
+
+		// PK cells only change through ChangePrimaryKey
+		if (*ColumnIndex == INDEX_NONE || *ColumnIndex == PKIndex)
+		{
+			continue;
+		}
+
+		if (Table.GetColumn(*ColumnIndex).Type != Command.Cell.Type)
+		{
+			continue;
+		}
+
+		int32* RowIndex = RowCache.Find(Command.PKValue);
+		if (!RowIndex)
+		{
+			RowIndex = &RowCache.Add(Command.PKValue, Table.FindRowIndex(Command.PKValue));
+		}
+
+		if (*RowIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		const TPair<int32, int32> CellKey(*RowIndex, *ColumnIndex);
+
+		// ---- coalesce: a later write to the same cell replaces the earlier one ----
+		if (const int32* Slot = Latest.Find(CellKey))
+		{
+			Writes[*Slot].CommandIndex = CommandIndex;
+		}
+		else
+		{
+			Latest.Add(CellKey, Writes.Add({ *ColumnIndex, *RowIndex, CommandIndex }));
+		}
+	}
+
+	// Column-major, then storage order: each column is written in one sweep
+	Writes.Sort(
+		[](const FCellWrite& A, const FCellWrite& B)
+		{
+			return A.ColumnIndex != B.ColumnIndex
+				? A.ColumnIndex < B.ColumnIndex
+				: A.RowIndex < B.RowIndex;
+		}
+	);
+
+	for (const FCellWrite& Write : Writes)
+	{
+		Table.SetCellAt(
+			Write.RowIndex,
+			Write.ColumnIndex,
+			MoveTemp(Commands[Write.CommandIndex].Cell)
+		);
+	}
+
+	return Writes.Num();
+}
+
+bool FBPDT_CommandBuffer::ApplyInsertRow(FBPDT_Table& Table, FBPDT_Command& Command)
+{
+	const TArray<FBPDT_Column>& Columns = Table.GetColumns();
+	if (Command.RowCells.Num() != Columns.Num())
+	{
+		return false;
+	}
+
+	FBPDT_Row Row;
+	Row.Cells = MoveTemp(Command.RowCells);
+
+	for (int32 i = 0; i < Columns.Num(); ++i)
+	{
+		FBPDT_Cell& Cell = Row.Cells[i];
+
+		if (Cell.Type == EBPDT_CellType::None)
+		{
+			Cell = FBPDT_Cell::MakeNull(Columns[i].Type);
+		}
+		else if (Cell.Type != Columns[i].Type)
+		{
+			return false;
+		}
+	}
+
+	return Table.InsertRow(Row);
+}
+
+/* ===================== FRAME HOOK ===================== */
+
+void FBPDT_CommandBuffer::Startup()
+{
+	HookFrameDelegate();
+}
+
+void FBPDT_CommandBuffer::Shutdown()
+{
+	UnhookFrameDelegate();
+
+	// Nothing queued is lost on a clean shutdown
+	if (IsInGameThread())
+	{
+		Flush();
+	}
+}
+
+void FBPDT_CommandBuffer::SetFlushPoint(EBPDT_CommandFlushPoint NewFlushPoint)
+{
+	check(IsInGameThread());
+
+	UnhookFrameDelegate();
+	FlushPoint = NewFlushPoint;
+	HookFrameDelegate();
+}
+
+void FBPDT_CommandBuffer::HookFrameDelegate()
+{
+	switch (FlushPoint)
+	{
+	case EBPDT_CommandFlushPoint::BeginFrame:
+		FrameHandle = FCoreDelegates::OnBeginFrame.AddRaw(this, &FBPDT_CommandBuffer::OnFrameBoundary);
+		break;
+
+	case EBPDT_CommandFlushPoint::EndFrame:
+		FrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FBPDT_CommandBuffer::OnFrameBoundary);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void FBPDT_CommandBuffer::UnhookFrameDelegate()
+{
+	if (!FrameHandle.IsValid())
+	{
+		return;
+	}
+
+	FCoreDelegates::OnBeginFrame.Remove(FrameHandle);
+	FCoreDelegates::OnEndFrame.Remove(FrameHandle);
+	FrameHandle.Reset();
+}
+
+void FBPDT_CommandBuffer::OnFrameBoundary()
+{
+	Flush();
+}
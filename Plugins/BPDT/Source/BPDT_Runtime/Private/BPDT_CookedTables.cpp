@@ -0,0 +1,760 @@
+#include "BPDT_CookedTables.h"
+
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformProperties.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Crc.h"
+
+/*
+ * Cooked file layout. Little-endian, every section starts 8-byte aligned;
+ * offsets are from the start of the file.
+ *
+ *   header      magic, version, table count, FK count (uint32 each),
+ *               string pool offset, FK offset (uint64 each)
+ *   directory   FCookedTable per table, sorted by name
+ *   per table   FCookedColumn per column, then the PK order: int32 row
+ *               positions sorted by PK (Int by value, String by bytes)
+ *   per column  one slot per row (Int, Float: 4 bytes, Bool: 1, Vector3:
+ *               an FVector, String: uint32 pool id), then a null bitmap
+ *               (bit per row, set = null) when the column has nulls
+ *   FKs         4 pool ids per constraint: FK table, FK column, PK table, PK column
+ *   pool        count (uint32), count + 1 offsets (uint32), then the bytes.
+ *               Names, string cells and column defaults, each stored once.
+ */
+
+static constexpr uint32 BPDT_COOKED_MAGIC = 0x4250444B; // 'BPDK'
+static constexpr uint32 BPDT_COOKED_VERSION = 1;
+
+struct FBPDT_CookedHeader
+{
+	uint32 Magic;
+	uint32 Version;
+	uint32 TableCount;
+	uint32 ForeignKeyCount;
+	uint64 StringsOffset;
+	uint64 ForeignKeysOffset;
+};
+static_assert(sizeof(FBPDT_CookedHeader) == 32, "Cooked header layout");
+
+struct FBPDT_CookedTables::FCookedTable
+{
+	uint32 Name;
+	uint32 ColumnCount;
+	uint32 PKColumn;
+	int32 NextSerialID;
+	int32 RowCount;
+	uint8 PKMode;
+	uint8 Padding[3];
+	uint64 ColumnsOffset;
+	uint64 PKOrderOffset;
+};
+static_assert(sizeof(FBPDT_CookedTables::FCookedTable) == 40, "Cooked table layout");
+
+struct FBPDT_CookedTables::FCookedColumn
+{
+	uint32 Name;
+	uint32 Default;
+	int32 ByteSize;
+	uint8 Type;
+	uint8 Padding[3];
+	uint64 ValuesOffset;
+	// 0 = no nulls
+	uint64 NullsOffset;
+};
+static_assert(sizeof(FBPDT_CookedTables::FCookedColumn) == 32, "Cooked column layout");
+
+static int32 GetSlotBytes(EBPDT_CellType Type)
+{
+	switch (Type)
+	{
+	case EBPDT_CellType::Int:     return sizeof(int32);
+	case EBPDT_CellType::Float:   return sizeof(float);
+	case EBPDT_CellType::Bool:    return sizeof(bool);
+	case EBPDT_CellType::Vector3: return sizeof(FVector);
+	case EBPDT_CellType::String:  return sizeof(uint32);
+	default:                      return 0;
+	}
+}
+
+static int64 GetNullBytes(int32 RowCount)
+{
+	return ((int64)RowCount + 7) / 8;
+}
+
+/* Orders PK cells: Int by value, anything else by its bytes */
+static int32 ComparePK(EBPDT_CellType Type, const uint8* A, int32 LenA, const uint8* B, int32 LenB)
+{
+	if (Type == EBPDT_CellType::Int)
+	{
+		int32 ValueA;
+		int32 ValueB;
+		FMemory::Memcpy(&ValueA, A, sizeof(int32));
+		FMemory::Memcpy(&ValueB, B, sizeof(int32));
+		return ValueA < ValueB ? -1 : (ValueA > ValueB ? 1 : 0);
+	}
+
+	const int32 Common = FMath::Min(LenA, LenB);
+	const int32 Result = Common > 0 ? FMemory::Memcmp(A, B, Common) : 0;
+	return Result != 0 ? Result : LenA - LenB;
+}
+
+FBPDT_CookedTables::~FBPDT_CookedTables() = default;
+
+FBPDT_CookedTables& FBPDT_CookedTables::Get()
+{
+	static FBPDT_CookedTables Instance;
+	return Instance;
+}
+
+FString FBPDT_CookedTables::GetCookedPath()
+{
+	return FPaths::ProjectContentDir() / TEXT("BPDT/Cooked/Tables.bpdtc");
+}
+
+/* ===================== MOUNT ===================== */
+
+bool FBPDT_CookedTables::Mount()
+{
+	// The editor and uncooked runs work on Saved/ only
+	if (IsMounted() || !FPlatformProperties::RequiresCookedData())
+	{
+		return IsMounted();
+	}
+
+	const FString Path = GetCookedPath();
+
+	IPlatformFile& PF =
+		FPlatformFileManager::Get().GetPlatformFile();
+
+	if (!PF.FileExists(*Path))
+	{
+		return false;
+	}
+
+	// ---- mapped: shared, read-only pages ----
+	FOpenMappedResult Mapped = PF.OpenMappedEx(*Path);
+	if (Mapped.HasValue())
+	{
+		MappedFile = Mapped.StealValue();
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+
+		if (MappedRegion)
+		{
+			Data = MappedRegion->GetMappedPtr();
+			Size = MappedRegion->GetMappedSize();
+		}
+	}
+
+	// ---- fallback: one read into memory ----
+	if (!Data)
+	{
+		MappedRegion.Reset();
+		MappedFile.Reset();
+
+		if (!FFileHelper::LoadFileToArray(Contents, *Path))
+		{
+			return false;
+		}
+
+		Data = Contents.GetData();
+		Size = Contents.Num();
+	}
+
+	if (!Validate())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[BPDT] Cooked tables '%s' are damaged or from another version; ignored."), *Path);
+		Unmount();
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("[BPDT] Mounted %d cooked tables (%s)."),
+		TableIndex.Num(), MappedRegion ? TEXT("mapped") : TEXT("in memory"));
+	return true;
+}
+
+void FBPDT_CookedTables::Unmount()
+{
+	TableIndex.Reset();
+	Data = nullptr;
+	Size = 0;
+
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	Contents.Empty();
+}
+
+/* Bounds of every section, so the readers can trust the offsets; O(tables + columns + strings) */
+bool FBPDT_CookedTables::Validate()
+{
+	auto InFile = [this](uint64 Offset, uint64 Bytes)
+	{
+		return Offset % 8 == 0 && Offset <= (uint64)Size && Bytes <= (uint64)Size - Offset;
+	};
+
+	if (!InFile(0, sizeof(FBPDT_CookedHeader)))
+	{
+		return false;
+	}
+
+	const FBPDT_CookedHeader& Header = *reinterpret_cast<const FBPDT_CookedHeader*>(Data);
+	if (Header.Magic != BPDT_COOKED_MAGIC || Header.Version != BPDT_COOKED_VERSION)
+	{
+		return false;
+	}
+
+	// ---- string pool ----
+	if (!InFile(Header.StringsOffset, sizeof(uint32)))
+	{
+		return false;
+	}
+
+	const uint32 StringCount = *reinterpret_cast<const uint32*>(Data + Header.StringsOffset);
+	const uint64 OffsetsBytes = ((uint64)StringCount + 1) * sizeof(uint32);
+	if (!InFile(Header.StringsOffset, sizeof(uint32) + OffsetsBytes))
+	{
+		return false;
+	}
+
+	const uint32* Offsets = reinterpret_cast<const uint32*>(Data + Header.StringsOffset + sizeof(uint32));
+	const uint64 PoolBegin = Header.StringsOffset + sizeof(uint32) + OffsetsBytes;
+	if (Offsets[0] != 0 || Offsets[StringCount] > (uint64)Size - PoolBegin)
+	{
+		return false;
+	}
+
+	for (uint32 i = 0; i < StringCount; ++i)
+	{
+		if (Offsets[i] > Offsets[i + 1])
+		{
+			return false;
+		}
+	}
+
+	// ---- FKs ----
+	if (!InFile(Header.ForeignKeysOffset, (uint64)Header.ForeignKeyCount * 4 * sizeof(uint32)))
+	{
+		return false;
+	}
+
+	// ---- tables ----
+	if (!InFile(sizeof(FBPDT_CookedHeader), (uint64)Header.TableCount * sizeof(FCookedTable)))
+	{
+		return false;
+	}
+
+	TableIndex.Reset();
+	TableIndex.Reserve(Header.TableCount);
+
+	const FCookedTable* Tables = reinterpret_cast<const FCookedTable*>(Data + sizeof(FBPDT_CookedHeader));
+	for (uint32 t = 0; t < Header.TableCount; ++t)
+	{
+		const FCookedTable& Table = Tables[t];
+
+		if (Table.RowCount < 0 ||
+			Table.PKColumn >= Table.ColumnCount ||
+			!InFile(Table.ColumnsOffset, (uint64)Table.ColumnCount * sizeof(FCookedColumn)) ||
+			!InFile(Table.PKOrderOffset, (uint64)Table.RowCount * sizeof(int32)))
+		{
+			return false;
+		}
+
+		const FCookedColumn* Columns = GetColumns(Table);
+		for (uint32 c = 0; c < Table.ColumnCount; ++c)
+		{
+			const FCookedColumn& Column = Columns[c];
+			const int32 SlotBytes = GetSlotBytes((EBPDT_CellType)Column.Type);
+
+			if (SlotBytes == 0 ||
+				!InFile(Column.ValuesOffset, (uint64)Table.RowCount * SlotBytes) ||
+				(Column.NullsOffset != 0 && !InFile(Column.NullsOffset, GetNullBytes(Table.RowCount))))
+			{
+				return false;
+			}
+		}
+
+		TableIndex.Add(GetStringAsText(Table.Name), t);
+	}
+
+	return true;
+}
+
+/* ===================== READ ===================== */
+
+const FBPDT_CookedTables::FCookedTable* FBPDT_CookedTables::FindTable(const FString& TableName) const
+{
+	const int32* Index = TableIndex.Find(TableName);
+	if (!Index)
+	{
+		return nullptr;
+	}
+
+	return reinterpret_cast<const FCookedTable*>(Data + sizeof(FBPDT_CookedHeader)) + *Index;
+}
+
+const FBPDT_CookedTables::FCookedColumn* FBPDT_CookedTables::GetColumns(const FCookedTable& Table) const
+{
+	return reinterpret_cast<const FCookedColumn*>(Data + Table.ColumnsOffset);
+}
+
+bool FBPDT_CookedTables::GetString(uint32 Id, const uint8*& OutBytes, int32& OutLen) const
+{
+	const FBPDT_CookedHeader& Header = *reinterpret_cast<const FBPDT_CookedHeader*>(Data);
+
+	const uint32 StringCount = *reinterpret_cast<const uint32*>(Data + Header.StringsOffset);
+	if (Id >= StringCount)
+	{
+		return false;
+	}
+
+	const uint32* Offsets = reinterpret_cast<const uint32*>(Data + Header.StringsOffset + sizeof(uint32));
+	const uint8* Pool = reinterpret_cast<const uint8*>(Offsets + StringCount + 1);
+
+	OutBytes = Pool + Offsets[Id];
+	OutLen = (int32)(Offsets[Id + 1] - Offsets[Id]);
+	return true;
+}
+
+FString FBPDT_CookedTables::GetStringAsText(uint32 Id) const
+{
+	const uint8* Bytes = nullptr;
+	int32 Len = 0;
+	if (!GetString(Id, Bytes, Len))
+	{
+		return FString();
+	}
+
+	FUTF8ToTCHAR Conv(reinterpret_cast<const ANSICHAR*>(Bytes), Len);
+	return FString(Conv.Length(), Conv.Get());
+}
+
+void FBPDT_CookedTables::GetTableNames(TArray<FString>& OutTableNames) const
+{
+	TableIndex.GetKeys(OutTableNames);
+}
+
+void FBPDT_CookedTables::GetForeignKeys(TArray<FBPDT_ForeignKeyConstraint>& OutForeignKeys) const
+{
+	OutForeignKeys.Reset();
+	if (!IsMounted())
+	{
+		return;
+	}
+
+	const FBPDT_CookedHeader& Header = *reinterpret_cast<const FBPDT_CookedHeader*>(Data);
+	const uint32* Ids = reinterpret_cast<const uint32*>(Data + Header.ForeignKeysOffset);
+
+	for (uint32 i = 0; i < Header.ForeignKeyCount; ++i, Ids += 4)
+	{
+		FBPDT_ForeignKeyConstraint& FK = OutForeignKeys.AddDefaulted_GetRef();
+		FK.FKTable = GetStringAsText(Ids[0]);
+		FK.FKColumn = FName(*GetStringAsText(Ids[1]));
+		FK.PKTable = GetStringAsText(Ids[2]);
+		FK.PKColumn = FName(*GetStringAsText(Ids[3]));
+	}
+}
+
+bool FBPDT_CookedTables::ReadSchema(
+	const FString& TableName,
+	EBPDT_PrimaryKeyMode& OutPKMode,
+	FName& OutPKColumnName,
+	TArray<FBPDT_Column>& OutColumns,
+	int32& OutNextSerialID,
+	int32& OutRowCount
+) const
+{
+	const FCookedTable* Table = FindTable(TableName);
+	if (!Table)
+	{
+		return false;
+	}
+
+	const FCookedColumn* Columns = GetColumns(*Table);
+
+	OutColumns.Reset(Table->ColumnCount);
+	for (uint32 c = 0; c < Table->ColumnCount; ++c)
+	{
+		const uint8* Default = nullptr;
+		int32 DefaultLen = 0;
+		if (!GetString(Columns[c].Default, Default, DefaultLen) || DefaultLen != Columns[c].ByteSize)
+		{
+			return false;
+		}
+
+		OutColumns.Emplace(
+			FName(*GetStringAsText(Columns[c].Name)),
+			(EBPDT_CellType)Columns[c].Type,
+			Default,
+			DefaultLen
+		);
+	}
+
+	OutPKMode = (EBPDT_PrimaryKeyMode)Table->PKMode;
+	OutPKColumnName = OutColumns[Table->PKColumn].Name;
+	OutNextSerialID = Table->NextSerialID;
+	OutRowCount = Table->RowCount;
+	return true;
+}
+
+bool FBPDT_CookedTables::ReadCells(
+	const FString& TableName,
+	int32 ColumnIndex,
+	int32 Begin,
+	int32 End,
+	TArray<FBPDT_Cell>& OutCells
+) const
+{
+	const FCookedTable* Table = FindTable(TableName);
+	if (!Table ||
+		ColumnIndex < 0 || (uint32)ColumnIndex >= Table->ColumnCount ||
+		Begin < 0 || Begin > End || End > Table->RowCount)
+	{
+		return false;
+	}
+
+	const FCookedColumn& Column = GetColumns(*Table)[ColumnIndex];
+	const EBPDT_CellType Type = (EBPDT_CellType)Column.Type;
+	const int32 SlotBytes = GetSlotBytes(Type);
+
+	const uint8* Values = Data + Column.ValuesOffset;
+	const uint8* Nulls = Column.NullsOffset != 0 ? Data + Column.NullsOffset : nullptr;
+
+	OutCells.Reset(End - Begin);
+	for (int32 Row = Begin; Row < End; ++Row)
+	{
+		if (Nulls && (Nulls[Row >> 3] & (1 << (Row & 7))))
+		{
+			OutCells.Add(FBPDT_Cell::MakeNull(Type));
+			continue;
+		}
+
+		const uint8* Slot = Values + (int64)Row * SlotBytes;
+		if (Type != EBPDT_CellType::String)
+		{
+			OutCells.Emplace(Type, Slot, SlotBytes);
+			continue;
+		}
+
+		uint32 Id;
+		FMemory::Memcpy(&Id, Slot, sizeof(uint32));
+
+		const uint8* Bytes = nullptr;
+		int32 Len = 0;
+		if (!GetString(Id, Bytes, Len))
+		{
+			return false;
+		}
+
+		if (Len > 0)
+		{
+			OutCells.Emplace(Type, Bytes, Len);
+		}
+		else
+		{
+			FBPDT_Cell& Cell = OutCells.AddDefaulted_GetRef();
+			Cell.Type = EBPDT_CellType::String;
+			Cell.bIsNull = false;
+		}
+	}
+
+	return true;
+}
+
+bool FBPDT_CookedTables::FindRow(const FString& TableName, const FString& PKValue, int32& OutRowIndex) const
+{
+	OutRowIndex = INDEX_NONE;
+
+	const FCookedTable* Table = FindTable(TableName);
+	if (!Table)
+	{
+		return false;
+	}
+
+	const FCookedColumn& Column = GetColumns(*Table)[Table->PKColumn];
+	const EBPDT_CellType Type = (EBPDT_CellType)Column.Type;
+
+	// ---- the key as the PK column stores it ----
+	TArray<uint8> Key;
+	if (Type == EBPDT_CellType::Int)
+	{
+		// Only the canonical spelling matches, as with FBPDT_PrimaryKey::ToString
+		int32 Value = 0;
+		if (!LexTryParseString(Value, *PKValue) || FString::FromInt(Value) != PKValue)
+		{
+			return true;
+		}
+		Key.Append(reinterpret_cast<const uint8*>(&Value), sizeof(int32));
+	}
+	else if (Type == EBPDT_CellType::String)
+	{
+		FTCHARToUTF8 Conv(*PKValue);
+		Key.Append(reinterpret_cast<const uint8*>(Conv.Get()), Conv.Length());
+	}
+	else
+	{
+		// Other PK types have no text form to look up by
+		return false;
+	}
+
+	// ---- binary search over the PK order ----
+	const int32* Order = reinterpret_cast<const int32*>(Data + Table->PKOrderOffset);
+	const uint8* Values = Data + Column.ValuesOffset;
+
+	int32 Low = 0;
+	int32 High = Table->RowCount;
+	while (Low < High)
+	{
+		const int32 Mid = Low + (High - Low) / 2;
+		const int32 Row = Order[Mid];
+		if (Row < 0 || Row >= Table->RowCount)
+		{
+			return false;
+		}
+
+		const uint8* Bytes = Values + (int64)Row * sizeof(int32);
+		int32 Len = sizeof(int32);
+		if (Type == EBPDT_CellType::String)
+		{
+			uint32 Id;
+			FMemory::Memcpy(&Id, Bytes, sizeof(uint32));
+			if (!GetString(Id, Bytes, Len))
+			{
+				return false;
+			}
+		}
+
+		const int32 Cmp = ComparePK(Type, Bytes, Len, Key.GetData(), Key.Num());
+		if (Cmp == 0)
+		{
+			OutRowIndex = Row;
+			return true;
+		}
+
+		if (Cmp < 0)
+		{
+			Low = Mid + 1;
+		}
+		else
+		{
+			High = Mid;
+		}
+	}
+
+	return true;
+}
+
+/* ===================== WRITE ===================== */
+
+#if WITH_EDITOR
+
+namespace
+{
+	struct FPoolKey
+	{
+		TArray<uint8> Bytes;
+
+		bool operator==(const FPoolKey& Other) const { return Bytes == Other.Bytes; }
+
+		friend uint32 GetTypeHash(const FPoolKey& Key)
+		{
+			return FCrc::MemCrc32(Key.Bytes.GetData(), Key.Bytes.Num());
+		}
+	};
+
+	/* Interned byte strings, in first-use order */
+	struct FStringPool
+	{
+		TMap<FPoolKey, uint32> Ids;
+		TArray<uint32> Offsets = { 0 };
+		TArray<uint8> Bytes;
+
+		uint32 Add(const uint8* Data, int32 Len)
+		{
+			FPoolKey Key;
+			Key.Bytes.Append(Data, Len);
+
+			if (const uint32* Existing = Ids.Find(Key))
+			{
+				return *Existing;
+			}
+
+			const uint32 Id = Offsets.Num() - 1;
+			Bytes.Append(Data, Len);
+			Offsets.Add(Bytes.Num());
+			Ids.Add(MoveTemp(Key), Id);
+			return Id;
+		}
+
+		uint32 Add(const FString& Text)
+		{
+			FTCHARToUTF8 Conv(*Text);
+			return Add(reinterpret_cast<const uint8*>(Conv.Get()), Conv.Length());
+		}
+	};
+
+	/* Appends Len bytes at an 8-aligned offset, returns it */
+	uint64 AppendAligned(TArray64<uint8>& Out, const void* Data, int64 Len)
+	{
+		Out.SetNumZeroed(Align(Out.Num(), 8));
+		const uint64 Offset = Out.Num();
+		Out.Append(static_cast<const uint8*>(Data), Len);
+		return Offset;
+	}
+}
+
+bool FBPDT_CookedTables::Write(
+	const FString& Path,
+	const TMap<FString, FBPDT_Table>& Tables,
+	const TArray<FBPDT_ForeignKeyConstraint>& ForeignKeys
+)
+{
+	FStringPool Pool;
+	TArray64<uint8> Out;
+
+	TArray<FString> Names;
+	Tables.GetKeys(Names);
+	Names.Sort();
+
+	// ---- header and directory first, filled in at the end ----
+	TArray<FCookedTable> Directory;
+	Directory.SetNumZeroed(Names.Num());
+
+	Out.SetNumZeroed(sizeof(FBPDT_CookedHeader) + Directory.Num() * sizeof(FCookedTable));
+
+	for (int32 t = 0; t < Names.Num(); ++t)
+	{
+		const FBPDT_Table& Table = Tables[Names[t]];
+		const TArray<FBPDT_Column>& Columns = Table.GetColumns();
+		const int32 RowCount = Table.GetRowCount();
+
+		const int32 PKIndex = Table.GetColumnIndex(Table.GetPKColumnName());
+		if (PKIndex == INDEX_NONE)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[BPDT] Cannot cook '%s': no PK column."), *Names[t]);
+			return false;
+		}
+
+		FCookedTable& Entry = Directory[t];
+		Entry.Name = Pool.Add(Names[t]);
+		Entry.ColumnCount = Columns.Num();
+		Entry.PKColumn = PKIndex;
+		Entry.NextSerialID = Table.NextSerialID;
+		Entry.RowCount = RowCount;
+		Entry.PKMode = (uint8)Table.PKMode;
+
+		// ---- column data ----
+		TArray<FCookedColumn> CookedColumns;
+		CookedColumns.SetNumZeroed(Columns.Num());
+
+		for (int32 c = 0; c < Columns.Num(); ++c)
+		{
+			const FBPDT_Column& Col = Columns[c];
+			const int32 SlotBytes = GetSlotBytes(Col.Type);
+
+			FCookedColumn& Cooked = CookedColumns[c];
+			Cooked.Name = Pool.Add(Col.Name.ToString());
+			Cooked.Default = Pool.Add(Col.DefaultData.GetData(), Col.DefaultData.Num());
+			Cooked.ByteSize = Col.ByteSize;
+			Cooked.Type = (uint8)Col.Type;
+
+			TArray64<uint8> Values;
+			Values.SetNumZeroed((int64)RowCount * SlotBytes);
+
+			TArray64<uint8> Nulls;
+			Nulls.SetNumZeroed(GetNullBytes(RowCount));
+			bool bHasNulls = false;
+
+			for (int32 Row = 0; Row < RowCount; ++Row)
+			{
+				const FBPDT_Cell& Cell = Table.GetCellAt(Row, c);
+				uint8* Slot = Values.GetData() + (int64)Row * SlotBytes;
+
+				if (Cell.bIsNull)
+				{
+					Nulls[Row >> 3] |= 1 << (Row & 7);
+					bHasNulls = true;
+				}
+				else if (Col.Type == EBPDT_CellType::String)
+				{
+					const uint32 Id = Pool.Add(Cell.Data.GetData(), Cell.Data.Num());
+					FMemory::Memcpy(Slot, &Id, sizeof(uint32));
+				}
+				else if (Cell.Data.Num() == SlotBytes)
+				{
+					FMemory::Memcpy(Slot, Cell.Data.GetData(), SlotBytes);
+				}
+				else
+				{
+					UE_LOG(LogTemp, Warning, TEXT("[BPDT] Cannot cook '%s': malformed cell in column '%s'."),
+						*Names[t], *Col.Name.ToString());
+					return false;
+				}
+			}
+
+			Cooked.ValuesOffset = AppendAligned(Out, Values.GetData(), Values.Num());
+			if (bHasNulls)
+			{
+				Cooked.NullsOffset = AppendAligned(Out, Nulls.GetData(), Nulls.Num());
+			}
+		}
+
+		Entry.ColumnsOffset = AppendAligned(Out, CookedColumns.GetData(), CookedColumns.Num() * sizeof(FCookedColumn));
+
+		// ---- PK order ----
+		TArray<int32> Order;
+		Order.SetNumUninitialized(RowCount);
+		for (int32 Row = 0; Row < RowCount; ++Row)
+		{
+			Order[Row] = Row;
+		}
+
+		const EBPDT_CellType PKType = Columns[PKIndex].Type;
+		Order.Sort([&Table, PKIndex, PKType](int32 A, int32 B)
+		{
+			const FBPDT_Cell& CellA = Table.GetCellAt(A, PKIndex);
+			const FBPDT_Cell& CellB = Table.GetCellAt(B, PKIndex);
+			return ComparePK(PKType, CellA.Data.GetData(), CellA.Data.Num(), CellB.Data.GetData(), CellB.Data.Num()) < 0;
+		});
+
+		Entry.PKOrderOffset = AppendAligned(Out, Order.GetData(), Order.Num() * sizeof(int32));
+	}
+
+	// ---- FKs ----
+	TArray<uint32> ForeignKeyIds;
+	for (const FBPDT_ForeignKeyConstraint& FK : ForeignKeys)
+	{
+		ForeignKeyIds.Add(Pool.Add(FK.FKTable));
+		ForeignKeyIds.Add(Pool.Add(FK.FKColumn.ToString()));
+		ForeignKeyIds.Add(Pool.Add(FK.PKTable));
+		ForeignKeyIds.Add(Pool.Add(FK.PKColumn.ToString()));
+	}
+
+	FBPDT_CookedHeader Header;
+	Header.Magic = BPDT_COOKED_MAGIC;
+	Header.Version = BPDT_COOKED_VERSION;
+	Header.TableCount = Directory.Num();
+	Header.ForeignKeyCount = ForeignKeys.Num();
+	Header.ForeignKeysOffset = AppendAligned(Out, ForeignKeyIds.GetData(), ForeignKeyIds.Num() * sizeof(uint32));
+
+	// ---- pool last: it grew with every table ----
+	const uint32 StringCount = Pool.Offsets.Num() - 1;
+	Header.StringsOffset = AppendAligned(Out, &StringCount, sizeof(uint32));
+	Out.Append(reinterpret_cast<const uint8*>(Pool.Offsets.GetData()), Pool.Offsets.Num() * sizeof(uint32));
+	Out.Append(Pool.Bytes.GetData(), Pool.Bytes.Num());
+
+	FMemory::Memcpy(Out.GetData(), &Header, sizeof(Header));
+	FMemory::Memcpy(Out.GetData() + sizeof(Header), Directory.GetData(), Directory.Num() * sizeof(FCookedTable));
+
+	if (!FFileHelper::SaveArrayToFile(Out, *Path))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[BPDT] Failed to write '%s'."), *Path);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("[BPDT] Cooked %d tables, %d strings, %lld bytes to '%s'."),
+		Names.Num(), StringCount, Out.Num(), *Path);
+	return true;
+}
+
+#endif
@@ -1,294 +1,520 @@
 #include "BPDT_FileManager.h"
 
 #include "HAL/PlatformFileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Async/ParallelFor.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/Crc.h"
+#include "Misc/Compression.h"
+#include "HAL/FileManager.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "BPDT_ColumnChunk.h"
+#include "BPDT_CookedTables.h"
+#include "BPDT_PrefetchReader.h"
+
+#include <atomic>
 
 static constexpr uint32 BPDT_DATA_MAGIC = 0x42504454; // 'BPDT'
-static constexpr uint32 BPDT_DATA_VERSION = 1;
 
-/* ===================== PUBLIC ===================== */
-
-bool FBPDT_FileManager::WriteTable(
-	const FString& TableName,
-	const FBPDT_Table& Table
-)
+// v1: row-major, per-row null mask. Read only.
+static constexpr uint32 BPDT_DATA_VERSION_ROWS = 1;
+// v2: row groups of column chunks plus a footer directory. Read only.
+static constexpr uint32 BPDT_DATA_VERSION_COLUMNS = 2;
+// v3: v2 with every chunk stored as a block that may be compressed
+static constexpr uint32 BPDT_DATA_VERSION_BLOCKS = 3;
+
+// Version written by EncodeDataFile
+static constexpr uint32 BPDT_DATA_VERSION = BPDT_DATA_VERSION_BLOCKS;
+
+// Magic, version, row count, column count, then bytes per row (v1) or rows per group (v2)
+static constexpr int64 BPDT_DATA_HEADER_BYTES = 5 * sizeof(uint32);
+
+// v2 footer entry per chunk: offset + size
+static constexpr int64 BPDT_CHUNK_ENTRY_BYTES = sizeof(uint64) + sizeof(uint32);
+
+// v2 file tail: footer offset + magic
+static constexpr int64 BPDT_DATA_TAIL_BYTES = sizeof(uint64) + sizeof(uint32);
+
+// v3 block header: EBPDT_Compression of the payload + chunk bytes before compression
+static constexpr int64 BPDT_BLOCK_HEADER_BYTES = 2 * sizeof(uint32);
+
+// Incremental saves append; rewrite the file once garbage outweighs live data
+static constexpr int64 BPDT_COMPACT_GARBAGE_RATIO = 1;
+
+// Rows decoded per task when loading
+static constexpr int32 BPDT_LOAD_ROWS_PER_TASK = 4096;
+
+static TAutoConsoleVariable<bool> CVarBPDTMappedLoad(
+	TEXT("BPDT.MappedLoad"),
+	true,
+	TEXT("Memory-map table data files on load. When off, or when mapping fails, the file is read into memory instead."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<bool> CVarBPDTPrefetchLoad(
+	TEXT("BPDT.PrefetchLoad"),
+	true,
+	TEXT("Load tables by streaming their data files with async reads and decoding row groups as they arrive. Files without row groups, and all loads when off, go through BPDT.MappedLoad."),
+	ECVF_Default
+);
+
+/* ===================== CATALOG ===================== */
+
+/*
+ * The catalog is the only metadata file and the commit point of every save:
+ * table names, schemas (PK mode and next serial ID included), FK constraints
+ * and the committed length and CRC of each table's data file. Files are
+ * never rewritten under a name a catalog refers to (data files only grow
+ * past the length it records), so publishing a new catalog version switches
+ * every table and the FKs over at once. Anything a catalog does not refer to
+ * is garbage from an older or crashed save.
+ *
+ *   __BPDT_CATALOG.<version>.bin
+ *     magic, format (uint32 each), version (int64)
+ *     FK count (int32), per FK: FK table, FK column, PK table, PK column
+ *     cooked table names taken in so far (format 3+): count (int32), names
+ *     table count (int32), per table:
+ *       name, data file, data bytes (int64), data CRC (uint32), row count (int32),
+ *       PK mode (uint8), PK column, next serial ID (int32), compression (uint8, format 2+),
+ *       cooked (uint8, format 3+),
+ *       column count (int32), per column: name, type (uint8), byte size (int32), default bytes
+ *     CRC of everything above (uint32)
+ *
+ * Strings are FString archive strings. The layout before the catalog (a
+ * registry plus one scheme file per table and ForeignKeys.txt) is read once
+ * and migrated.
+ *
+ * Packaged builds with cooked tables (BPDT_CookedTables.h) add every cooked
+ * table the catalog has not seen yet as a cooked entry: no data file, rows
+ * read from the mapped cook until a save writes them to Saved/. The list of
+ * seen names keeps a dropped cooked table from coming back; a cooked entry's
+ * schema always comes from the current cook, so a patched build updates the
+ * tables the player never changed.
+ */
+
+static constexpr uint32 BPDT_CATALOG_MAGIC = 0x42504443; // 'BPDC'
+static constexpr uint32 BPDT_CATALOG_FORMAT = 3;
+
+struct FBPDT_CatalogEntry
 {
-	const FString Directory = GetSaveDirectory();
+	FString DataFile;
 
-	IPlatformFile& PF =
-		FPlatformFileManager::Get().GetPlatformFile();
+	// Committed length of DataFile and CRC of those bytes; -1 = whole file,
+	// CRC not known yet (migrated layout)
+	int64 DataBytes = -1;
+	uint32 DataCrc = 0;
+	int32 RowCount = 0;
 
-	if (!PF.DirectoryExists(*Directory))
-	{
-		PF.CreateDirectoryTree(*Directory);
-	}
+	EBPDT_PrimaryKeyMode PKMode = EBPDT_PrimaryKeyMode::Serial;
+	FName PKColumnName;
+	int32 NextSerialID = 1;
+	EBPDT_Compression Compression = EBPDT_Compression::None;
 
-	const FString SchemePath =
-		Directory / (TableName + TEXT("_Scheme.txt"));
+	// Rows are the cooked table of the same name, not a data file
+	bool bCooked = false;
 
-	const FString DataPath =
-		Directory / (TableName + TEXT("_Data.bin"));
+	// FK flags are not stored; the constraints are
+	TArray<FBPDT_Column> Columns;
 
-	if (!WriteSchemeFile(SchemePath, TableName, Table))
-	{
-		return false;
-	}
+	// Table version these files hold; 0 = unknown (not read or written yet). Not saved.
+	uint64 Version = 0;
+};
 
-	if (!WriteDataFile(DataPath, Table))
-	{
-		return false;
-	}
+struct FBPDT_Catalog
+{
+	int64 Version = 0;
+	TArray<FBPDT_ForeignKeyConstraint> ForeignKeys;
+	TArray<FString> CookedTables;
+	TMap<FString, FBPDT_CatalogEntry> Tables;
+};
 
-	// ---- REGISTER TABLE (NEW) ----
-	if (!AddTableToRegistry(TableName))
-	{
-		return false;
-	}
+// Published catalog, loaded on first use. Publishes are serialized by the
+// same lock so the version sequence has no gaps.
+static FBPDT_Catalog G_BPDT_Catalog;
+static bool G_BPDT_bCatalogLoaded = false;
+static FCriticalSection G_BPDT_CatalogMutex;
 
-	return true;
+static const TCHAR* BPDT_CATALOG_PREFIX = TEXT("__BPDT_CATALOG.");
+
+// Layout before the catalog; read once to migrate
+static const TCHAR* BPDT_LEGACY_REGISTRY = TEXT("__BPDT_TABLE_REGISTRY.txt");
+static const TCHAR* BPDT_LEGACY_FOREIGN_KEYS = TEXT("ForeignKeys.txt");
+
+static FString GetCatalogPath(int64 Version)
+{
+	return FBPDT_FileManager::GetSaveDirectory() /
+		FString::Printf(TEXT("%s%lld.bin"), BPDT_CATALOG_PREFIX, Version);
 }
 
-bool FBPDT_FileManager::ReadRegistry(TArray<FString>& OutTableNames)
+/* Versions of the files named <Prefix><version>.<Extension>, newest first */
+static void FindVersionedFiles(const TCHAR* Prefix, const TCHAR* Extension, TArray<int64>& OutVersions)
 {
-	const FString Path = GetRegistryPath();
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(
+		Files,
+		*(FBPDT_FileManager::GetSaveDirectory() / (FString(Prefix) + TEXT("*.") + Extension)),
+		true,
+		false
+	);
 
-	if (!FPaths::FileExists(Path))
+	OutVersions.Reset();
+	for (const FString& File : Files)
 	{
-		return true; // empty registry is valid
+		const FString Number = FPaths::GetBaseFilename(File).RightChop(FCString::Strlen(Prefix));
+		if (Number.IsNumeric())
+		{
+			OutVersions.Add(FCString::Atoi64(*Number));
+		}
 	}
-
-	return FFileHelper::LoadFileToStringArray(OutTableNames, *Path);
+	OutVersions.Sort(TGreater<int64>());
 }
 
-bool FBPDT_FileManager::IsTableInRegistry(const FString& TableName)
+/* CRC of a whole data file; MemCrc32 takes 32-bit lengths */
+static uint32 DataCrc32(const uint8* Data, int64 Size, uint32 Crc = 0)
 {
-	TArray<FString> Tables;
-	if (!ReadRegistry(Tables))
+	while (Size > 0)
 	{
-		return false;
+		const int32 Piece = (int32)FMath::Min<int64>(Size, MAX_int32);
+		Crc = FCrc::MemCrc32(Data, Piece, Crc);
+		Data += Piece;
+		Size -= Piece;
 	}
-
-	return Tables.Contains(TableName);
+	return Crc;
 }
 
-/* ===================== INTERNAL ===================== */
+// ---- binary form ----
 
-FString FBPDT_FileManager::GetSaveDirectory()
+static void SerializeName(FArchive& Ar, FName& Name)
 {
-	return FPaths::ProjectSavedDir() / TEXT("Plugins/BPDT");
+	FString Text = Name.ToString();
+	Ar << Text;
+
+	if (Ar.IsLoading())
+	{
+		Name = FName(*Text);
+	}
 }
 
-FString FBPDT_FileManager::GetRegistryPath()
+/* Counts come from the file; one that cannot fit in what is left is corrupt */
+static bool SerializeCount(FArchive& Ar, int32& Count, int32 Current)
 {
-	return FBPDT_FileManager::GetSaveDirectory() /
-		TEXT("__BPDT_TABLE_REGISTRY.txt");
+	Count = Current;
+	Ar << Count;
+
+	return !Ar.IsError() &&
+		(!Ar.IsLoading() || (Count >= 0 && Count <= Ar.TotalSize() - Ar.Tell()));
 }
 
-bool FBPDT_FileManager::AddTableToRegistry(const FString& TableName)
+static bool SerializeEntry(FArchive& Ar, uint32 Format, FBPDT_CatalogEntry& Entry)
 {
-	TArray<FString> Tables;
-	ReadRegistry(Tables);
+	uint8 PKMode = (uint8)Entry.PKMode;
+	uint8 Compression = (uint8)Entry.Compression;
+	uint8 bCooked = Entry.bCooked ? 1 : 0;
+
+	Ar << Entry.DataFile;
+	Ar << Entry.DataBytes;
+	Ar << Entry.DataCrc;
+	Ar << Entry.RowCount;
+	Ar << PKMode;
+	SerializeName(Ar, Entry.PKColumnName);
+	Ar << Entry.NextSerialID;
+	if (Format >= 2)
+	{
+		Ar << Compression;
+	}
+	if (Format >= 3)
+	{
+		Ar << bCooked;
+	}
+
+	Entry.PKMode = (EBPDT_PrimaryKeyMode)PKMode;
+	Entry.Compression = (EBPDT_Compression)Compression;
+	Entry.bCooked = bCooked != 0;
 
-	if (Tables.Contains(TableName))
+	int32 ColumnCount = 0;
+	if (!SerializeCount(Ar, ColumnCount, Entry.Columns.Num()))
 	{
-		return true; // already registered
+		return false;
 	}
 
-	Tables.Add(TableName);
+	Entry.Columns.SetNum(ColumnCount);
+	for (FBPDT_Column& Column : Entry.Columns)
+	{
+		uint8 Type = (uint8)Column.Type;
 
-	const FString Path = GetRegistryPath();
-	return FFileHelper::SaveStringArrayToFile(Tables, *Path);
-}
+		SerializeName(Ar, Column.Name);
+		Ar << Type;
+		Ar << Column.ByteSize;
+		Ar << Column.DefaultData;
 
+		Column.Type = (EBPDT_CellType)Type;
+	}
 
-/* ===================== SCHEME ===================== */
+	return !Ar.IsError();
+}
 
-bool FBPDT_FileManager::WriteSchemeFile(
-	const FString& Path,
-	const FString& TableName,
-	const FBPDT_Table& Table
-)
+/* Both directions; the CRC trailer is up to the caller */
+static bool SerializeCatalog(FArchive& Ar, FBPDT_Catalog& Catalog)
 {
-	FString Out;
-
-	const TArray<FBPDT_Column>& Columns = Table.GetColumns();
-	const int32 ColumnCount = Columns.Num();
-	const int32 RowCount = Table.GetRowCount();
+	uint32 Magic = BPDT_CATALOG_MAGIC;
+	uint32 Format = BPDT_CATALOG_FORMAT;
 
-	const int32 NullMaskBytes = (ColumnCount + 7) / 8;
+	Ar << Magic;
+	Ar << Format;
+	Ar << Catalog.Version;
 
-	int32 DataBytesPerRow = 0;
-	for (const FBPDT_Column& Col : Columns)
+	if (Ar.IsError() || Magic != BPDT_CATALOG_MAGIC || Format == 0 || Format > BPDT_CATALOG_FORMAT)
 	{
-		DataBytesPerRow += Col.ByteSize;
+		return false;
 	}
 
-	// ---- Header ----
-	Out += TEXT("Table=") + TableName + TEXT("\n");
-	Out += TEXT("RowCount=") + FString::FromInt(RowCount) + TEXT("\n");
-	Out += TEXT("ColumnCount=") + FString::FromInt(ColumnCount) + TEXT("\n");
-	Out += TEXT("NullMaskBytes=") + FString::FromInt(NullMaskBytes) + TEXT("\n");
-	Out += TEXT("BytesPerRow=") +
-		FString::FromInt(DataBytesPerRow + NullMaskBytes) + TEXT("\n\n");
+	// ---- FK constraints ----
+	int32 ForeignKeyCount = 0;
+	if (!SerializeCount(Ar, ForeignKeyCount, Catalog.ForeignKeys.Num()))
+	{
+		return false;
+	}
 
-	// ---- Columns ----
-	Out += TEXT("Name,Size,Type\n");
+	Catalog.ForeignKeys.SetNum(ForeignKeyCount);
+	for (FBPDT_ForeignKeyConstraint& FK : Catalog.ForeignKeys)
+	{
+		Ar << FK.FKTable;
+		SerializeName(Ar, FK.FKColumn);
+		Ar << FK.PKTable;
+		SerializeName(Ar, FK.PKColumn);
+	}
 
-	for (int32 i = 0; i < Columns.Num(); ++i)
+	// ---- cooked tables seen ----
+	if (Format >= 3)
 	{
-		const FBPDT_Column& Col = Columns[i];
+		int32 CookedCount = 0;
+		if (!SerializeCount(Ar, CookedCount, Catalog.CookedTables.Num()))
+		{
+			return false;
+		}
+
+		Catalog.CookedTables.SetNum(CookedCount);
+		for (FString& Name : Catalog.CookedTables)
+		{
+			Ar << Name;
+		}
+	}
 
-		FString TypeStr;
+	// ---- tables ----
+	int32 TableCount = 0;
+	if (!SerializeCount(Ar, TableCount, Catalog.Tables.Num()))
+	{
+		return false;
+	}
 
-		if (i == 0)
+	if (Ar.IsSaving())
+	{
+		for (auto& Pair : Catalog.Tables)
 		{
-			// PK is always first and serial
-			TypeStr = TEXT("SERIAL");
+			FString Name = Pair.Key;
+			Ar << Name;
+			SerializeEntry(Ar, Format, Pair.Value);
 		}
-		else
+		return !Ar.IsError();
+	}
+
+	Catalog.Tables.Reset();
+	for (int32 i = 0; i < TableCount; ++i)
+	{
+		FString Name;
+		FBPDT_CatalogEntry Entry;
+
+		Ar << Name;
+		if (!SerializeEntry(Ar, Format, Entry))
 		{
-			TypeStr =
-				StaticEnum<EBPDT_CellType>()
-				->GetNameStringByValue((int64)Col.Type);
+			return false;
 		}
 
-		Out += FString::Printf(
-			TEXT("%s,%d,%s\n"),
-			*Col.Name.ToString(),
-			Col.ByteSize,
-			*TypeStr
-		);
+		Catalog.Tables.Add(MoveTemp(Name), MoveTemp(Entry));
 	}
-
-	return FFileHelper::SaveStringToFile(Out, *Path);
+	return !Ar.IsError();
 }
 
+/* One read; the trailing CRC has to match */
+static bool ReadCatalog(const FString& Path, FBPDT_Catalog& OutCatalog)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path) || Bytes.Num() < (int32)sizeof(uint32))
+	{
+		return false;
+	}
 
-/* ===================== DATA ===================== */
+	const int32 BodyBytes = Bytes.Num() - sizeof(uint32);
 
-bool FBPDT_FileManager::WriteDataFile(
-	const FString& Path,
-	const FBPDT_Table& Table
-)
-{
-	TUniquePtr<FArchive> Ar(
-		IFileManager::Get().CreateFileWriter(*Path)
-	);
+	uint32 StoredCrc = 0;
+	FMemory::Memcpy(&StoredCrc, Bytes.GetData() + BodyBytes, sizeof(uint32));
 
-	if (!Ar)
+	if (FCrc::MemCrc32(Bytes.GetData(), BodyBytes) != StoredCrc)
 	{
 		return false;
 	}
 
-	const TArray<FBPDT_Column>& Columns = Table.GetColumns();
-	const int32 ColumnCount = Columns.Num();
-	const int32 NullMaskBytes = (ColumnCount + 7) / 8;
+	FMemoryReaderView Ar(MakeArrayView(Bytes.GetData(), BodyBytes));
+	return SerializeCatalog(Ar, OutCatalog) &&
+		Ar.Tell() == BodyBytes &&
+		OutCatalog.Version > 0;
+}
+
+/* One write, one flush */
+static bool WriteFileBytes(const FString& Path, const TArray<uint8>& Bytes)
+{
+	IPlatformFile& PF =
+		FPlatformFileManager::Get().GetPlatformFile();
+
+	TUniquePtr<IFileHandle> File(PF.OpenWrite(*Path));
+	return File &&
+		File->Write(Bytes.GetData(), Bytes.Num()) &&
+		File->Flush(/*bFullFlush*/ true);
+}
 
-	int32 DataBytesPerRow = 0;
-	for (const FBPDT_Column& Col : Columns)
+/* Writes the catalog under a temporary name, then renames it into place */
+static bool PublishCatalog(const FBPDT_Catalog& Catalog)
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Ar(Bytes);
+
+	// Saving leaves the catalog untouched
+	SerializeCatalog(Ar, const_cast<FBPDT_Catalog&>(Catalog));
+
+	uint32 Crc = FCrc::MemCrc32(Bytes.GetData(), Bytes.Num());
+	Ar << Crc;
+
+	const FString TempPath = FBPDT_FileManager::GetSaveDirectory() / (FString(BPDT_CATALOG_PREFIX) + TEXT("tmp"));
+	if (!WriteFileBytes(TempPath, Bytes))
 	{
-		DataBytesPerRow += Col.ByteSize;
+		return false;
 	}
 
-	uint32 Magic = BPDT_DATA_MAGIC;
-	uint32 Version = BPDT_DATA_VERSION;
-	uint32 RowCount = (uint32)Table.GetRowCount();
-	uint32 ColCount = (uint32)ColumnCount;
-	uint32 BytesPerRow = (uint32)(DataBytesPerRow + NullMaskBytes);
+	return IFileManager::Get().Move(*GetCatalogPath(Catalog.Version), *TempPath, /*Replace*/ false);
+}
 
-	(*Ar) << Magic;
-	(*Ar) << Version;
-	(*Ar) << RowCount;
-	(*Ar) << ColCount;
-	(*Ar) << BytesPerRow;
+/* <Prefix><decimal number><Suffix>, the shape of every versioned file name */
+static bool IsNumberedFileName(const FString& File, const TCHAR* Prefix, const TCHAR* Suffix)
+{
+	const int32 PrefixLen = FCString::Strlen(Prefix);
+	const int32 SuffixLen = FCString::Strlen(Suffix);
+
+	if (File.Len() <= PrefixLen + SuffixLen ||
+		!File.StartsWith(Prefix, ESearchCase::CaseSensitive) ||
+		!File.EndsWith(Suffix, ESearchCase::CaseSensitive))
+	{
+		return false;
+	}
 
-	Table.ForEachRow(
-		[&](const FBPDT_PrimaryKey&, const FBPDT_Row& Row)
+	for (int32 i = PrefixLen; i < File.Len() - SuffixLen; ++i)
+	{
+		if (!FChar::IsDigit(File[i]))
 		{
-			WriteNullMask(*Ar, Row, ColumnCount);
+			return false;
+		}
+	}
+	return true;
+}
 
-			for (int32 i = 0; i < ColumnCount; ++i)
-			{
-				const FBPDT_Cell& Cell = Row.GetCell(i);
-				const int32 ByteSize = Columns[i].ByteSize;
+/* <table name><Kind><Extension>, or with a version before the extension when bVersioned */
+static bool IsTableFileName(const FString& File, const TCHAR* Kind, const TCHAR* Extension, bool bVersioned)
+{
+	const int32 At = File.Find(Kind, ESearchCase::CaseSensitive, ESearchDir::FromEnd);
+	if (At <= 0)
+	{
+		return false;
+	}
 
-				if (!Cell.bIsNull && Cell.Data.Num() == ByteSize)
-				{
-					Ar->Serialize(
-						(void*)Cell.Data.GetData(),
-						ByteSize
-					);
-				}
-				else
-				{
-					TArray<uint8> Zero;
-					Zero.SetNumZeroed(ByteSize);
-					Ar->Serialize(Zero.GetData(), ByteSize);
-				}
-			}
+	for (int32 i = 0; i < At; ++i)
+	{
+		const TCHAR C = File[i];
+		if (!FChar::IsAlnum(C) && C != TEXT('_'))
+		{
+			return false;
 		}
-	);
+	}
 
-	Ar->Close();
-	return true;
+	const FString Rest = File.RightChop(At + FCString::Strlen(Kind));
+	return Rest.Equals(Extension, ESearchCase::CaseSensitive) ||
+		(bVersioned && IsNumberedFileName(Rest, TEXT("."), Extension));
 }
 
-/* ===================== NULL MASK ===================== */
+/* Names this plugin writes, now or in an earlier layout; nothing else is ever deleted */
+static bool IsGeneratedFileName(const FString& File)
+{
+	return
+		IsNumberedFileName(File, BPDT_CATALOG_PREFIX, TEXT(".bin")) ||
+		File == FString(BPDT_CATALOG_PREFIX) + TEXT("tmp") ||
+		File == BPDT_LEGACY_REGISTRY ||
+		File == BPDT_LEGACY_FOREIGN_KEYS ||
+		IsTableFileName(File, TEXT("_Data"), TEXT(".bin"), true) ||
+		IsTableFileName(File, TEXT("_Scheme"), TEXT(".txt"), false);
+}
 
-void FBPDT_FileManager::WriteNullMask(
-	FArchive& Ar,
-	const FBPDT_Row& Row,
-	int32 ColumnCount
-)
+/*
+ * Deletes generated files neither the published catalog nor the one before
+ * it refers to. Readers look a file up in the catalog and open it after
+ * releasing the catalog lock, so a superseded file lives on for one more
+ * publish; that also keeps the fallback catalog loadable.
+ */
+static void CollectGarbage(const FBPDT_Catalog& Catalog, const FBPDT_Catalog* Previous)
 {
-	const int32 Bytes = (ColumnCount + 7) / 8;
-	TArray<uint8> Mask;
-	Mask.SetNumZeroed(Bytes);
+	const FString Directory = FBPDT_FileManager::GetSaveDirectory();
 
-	for (int32 i = 0; i < ColumnCount; ++i)
+	TSet<FString> Live;
+	for (const FBPDT_Catalog* Kept : { &Catalog, Previous })
 	{
-		if (Row.GetCell(i).bIsNull)
+		if (!Kept)
+		{
+			continue;
+		}
+
+		Live.Add(FPaths::GetCleanFilename(GetCatalogPath(Kept->Version)));
+		for (const auto& Pair : Kept->Tables)
 		{
-			Mask[i / 8] |= (1 << (i % 8));
+			Live.Add(Pair.Value.DataFile);
 		}
 	}
 
-	Ar.Serialize(Mask.GetData(), Mask.Num());
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(Files, *(Directory / TEXT("*")), true, false);
+
+	for (const FString& File : Files)
+	{
+		if (IsGeneratedFileName(File) && !Live.Contains(File))
+		{
+			IFileManager::Get().Delete(*(Directory / File));
+		}
+	}
 }
 
-bool FBPDT_FileManager::ReadTable(
-	const FString& TableName,
-	FBPDT_Table& OutTable
+// ---- migration from the text layout ----
+
+/* Scheme file of the text layout: header lines, blank line, Name,Size,Type rows */
+static bool ReadLegacySchemeFile(
+	const FString& Path,
+	int32& OutRowCount,
+	TArray<FBPDT_Column>& OutColumns
 )
 {
-	const FString Directory = GetSaveDirectory();
-
-	const FString SchemePath =
-		Directory / (TableName + TEXT("_Scheme.txt"));
-
-	const FString DataPath =
-		Directory / (TableName + TEXT("_Data.bin"));
-
-	if (!FPaths::FileExists(SchemePath) ||
-		!FPaths::FileExists(DataPath))
+	if (!FPaths::FileExists(Path))
 	{
 		return false;
 	}
 
-	/* ---------- READ SCHEME ---------- */
-
 	TArray<FString> Lines;
-	if (!FFileHelper::LoadFileToStringArray(Lines, *SchemePath))
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Path))
 	{
 		return false;
 	}
 
-	int32 RowCount = 0;
 	int32 ColumnCount = 0;
-	int32 NullMaskBytes = 0;
-
-	TArray<FBPDT_Column> Columns;
+	OutRowCount = 0;
+	OutColumns.Reset();
 
 	int32 LineIndex = 0;
 
@@ -310,16 +536,12 @@ bool FBPDT_FileManager::ReadTable(
 
 		if (Key == TEXT("RowCount"))
 		{
-			RowCount = FCString::Atoi(*Value);
+			OutRowCount = FCString::Atoi(*Value);
 		}
 		else if (Key == TEXT("ColumnCount"))
 		{
 			ColumnCount = FCString::Atoi(*Value);
 		}
-		else if (Key == TEXT("NullMaskBytes"))
-		{
-			NullMaskBytes = FCString::Atoi(*Value);
-		}
 	}
 
 	// Skip CSV header
@@ -358,7 +580,7 @@ bool FBPDT_FileManager::ReadTable(
 		TArray<uint8> DefaultData;
 		DefaultData.SetNumZeroed(Size);
 
-		Columns.Emplace(
+		OutColumns.Emplace(
 			FName(*Name),
 			Type,
 			DefaultData.GetData(),
@@ -366,94 +588,1782 @@ bool FBPDT_FileManager::ReadTable(
 		);
 	}
 
-	if (Columns.Num() != ColumnCount)
+	return OutColumns.Num() == ColumnCount;
+}
+
+/**
+ * Builds a catalog from the registry file and the scheme files next to the
+ * data files. That layout always saved column 0 as a serial key and never
+ * stored defaults or the next serial ID; AppendRows derives the latter on
+ * load. Returns false when there is nothing to migrate; bOutComplete is
+ * false when some table could not be described.
+ */
+static bool ReadLegacyLayout(FBPDT_Catalog& OutCatalog, bool& bOutComplete)
+{
+	const FString Directory = FBPDT_FileManager::GetSaveDirectory();
+
+	OutCatalog = FBPDT_Catalog();
+	bOutComplete = true;
+
+	TArray<FString> TableNames;
+	const FString RegistryPath = Directory / BPDT_LEGACY_REGISTRY;
+	if (FPaths::FileExists(RegistryPath))
+	{
+		FFileHelper::LoadFileToStringArray(TableNames, *RegistryPath);
+	}
+	TableNames.RemoveAll([](const FString& TableName) { return TableName.IsEmpty(); });
+
+	const FString ForeignKeysPath = Directory / BPDT_LEGACY_FOREIGN_KEYS;
+	const bool bForeignKeys = FPaths::FileExists(ForeignKeysPath);
+
+	if (TableNames.Num() == 0 && !bForeignKeys)
 	{
 		return false;
 	}
 
-	/* ---------- INIT TABLE ---------- */
+	// ---- schemas ----
+	for (const FString& TableName : TableNames)
+	{
+		const FString SchemeFile = TableName + TEXT("_Scheme.txt");
 
-	OutTable = FBPDT_Table();
-	OutTable.InitSerial();
+		FBPDT_CatalogEntry Entry;
+		if (!ReadLegacySchemeFile(Directory / SchemeFile, Entry.RowCount, Entry.Columns) ||
+			Entry.Columns.Num() == 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[BPDT] Could not migrate table '%s': unreadable '%s'."),
+				*TableName, *SchemeFile);
+			bOutComplete = false;
+			continue;
+		}
+
+		Entry.DataFile = TableName + TEXT("_Data.bin");
+		Entry.DataBytes = -1;
+		Entry.PKMode = EBPDT_PrimaryKeyMode::Serial;
+		Entry.PKColumnName = Entry.Columns[0].Name;
+		OutCatalog.Tables.Add(TableName, MoveTemp(Entry));
+	}
 
-	for (int32 i = 1; i < Columns.Num(); ++i)
+	// ---- FK constraints: FKTable|FKColumn|PKTable|PKColumn per line ----
+	FString ForeignKeysText;
+	if (bForeignKeys && !FFileHelper::LoadFileToString(ForeignKeysText, *ForeignKeysPath))
 	{
-		const FBPDT_Column& Col = Columns[i];
-		OutTable.AddColumn(
-			Col.Name,
-			Col.Type,
-			Col.DefaultData.GetData(),
-			Col.ByteSize
-		);
+		bOutComplete = false;
 	}
 
-	/* ---------- READ DATA ---------- */
+	TArray<FString> Lines;
+	ForeignKeysText.ParseIntoArrayLines(Lines);
 
-	TUniquePtr<FArchive> Ar(
-		IFileManager::Get().CreateFileReader(*DataPath)
-	);
-	if (!Ar)
+	for (const FString& Line : Lines)
 	{
-		return false;
+		TArray<FString> Parts;
+		if (Line.ParseIntoArray(Parts, TEXT("|"), true) != 4)
+		{
+			continue; // malformed line
+		}
+
+		FBPDT_ForeignKeyConstraint& FK = OutCatalog.ForeignKeys.AddDefaulted_GetRef();
+		FK.FKTable = Parts[0];
+		FK.FKColumn = FName(*Parts[1]);
+		FK.PKTable = Parts[2];
+		FK.PKColumn = FName(*Parts[3]);
 	}
 
-	// Read binary header written by WriteDataFile
-	uint32 Magic = 0, Version = 0, BinRowCount = 0, BinColCount = 0, BinBytesPerRow = 0;
-	(*Ar) << Magic;
-	(*Ar) << Version;
-	(*Ar) << BinRowCount;
-	(*Ar) << BinColCount;
-	(*Ar) << BinBytesPerRow;
+	return true;
+}
+
+// ---- cooked tables ----
+
+/**
+ * Refreshes the cooked entries from the mounted cook, dropping those it no
+ * longer has, and adds the cooked tables the catalog has not seen yet.
+ * In memory only; the next save publishes the result.
+ */
+static void MergeCookedTables(FBPDT_Catalog& Catalog)
+{
+	const FBPDT_CookedTables& Cooked = FBPDT_CookedTables::Get();
 
-	if (Magic != BPDT_DATA_MAGIC || Version != BPDT_DATA_VERSION)
+	for (auto It = Catalog.Tables.CreateIterator(); It; ++It)
 	{
-		return false;
+		FBPDT_CatalogEntry& Entry = It.Value();
+		if (Entry.bCooked &&
+			!Cooked.ReadSchema(It.Key(), Entry.PKMode, Entry.PKColumnName, Entry.Columns, Entry.NextSerialID, Entry.RowCount))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[BPDT] Cooked table '%s' is not in this build any more; dropped."), *It.Key());
+			It.RemoveCurrent();
+		}
 	}
 
-	if ((int32)BinRowCount != RowCount || (int32)BinColCount != ColumnCount)
+	TArray<FString> Names;
+	Cooked.GetTableNames(Names);
+
+	TArray<FString> Added;
+	for (const FString& Name : Names)
 	{
-		return false;
+		if (Catalog.CookedTables.Contains(Name))
+		{
+			continue;
+		}
+		Catalog.CookedTables.Add(Name);
+
+		// A table saved under the same name wins
+		if (Catalog.Tables.Contains(Name))
+		{
+			continue;
+		}
+
+		FBPDT_CatalogEntry Entry;
+		Entry.bCooked = true;
+		if (Cooked.ReadSchema(Name, Entry.PKMode, Entry.PKColumnName, Entry.Columns, Entry.NextSerialID, Entry.RowCount))
+		{
+			Catalog.Tables.Add(Name, MoveTemp(Entry));
+			Added.Add(Name);
+		}
 	}
 
-	for (int32 RowIdx = 0; RowIdx < RowCount; ++RowIdx)
+	if (Added.Num() == 0)
 	{
-		TArray<uint8> NullMask;
-		NullMask.SetNumZeroed(NullMaskBytes);
-		Ar->Serialize(NullMask.GetData(), NullMaskBytes);
+		return;
+	}
 
-		FBPDT_Row Row(ColumnCount);
+	// Constraints of the new tables come with them
+	TArray<FBPDT_ForeignKeyConstraint> ForeignKeys;
+	Cooked.GetForeignKeys(ForeignKeys);
 
-		for (int32 ColIdx = 0; ColIdx < ColumnCount; ++ColIdx)
+	for (const FBPDT_ForeignKeyConstraint& FK : ForeignKeys)
+	{
+		if (Added.Contains(FK.FKTable) && Catalog.Tables.Contains(FK.PKTable))
 		{
-			const bool bIsNull =
-				(NullMask[ColIdx / 8] & (1 << (ColIdx % 8))) != 0;
+			Catalog.ForeignKeys.AddUnique(FK);
+		}
+	}
 
-			const FBPDT_Column& Col = Columns[ColIdx];
+	UE_LOG(LogTemp, Log, TEXT("[BPDT] Added %d cooked tables to the catalog."), Added.Num());
+}
 
-			if (bIsNull)
-			{
-				Row.SetCell(
-					ColIdx,
-					FBPDT_Cell::MakeNull(Col.Type)
-				);
-			}
+/* Caller holds G_BPDT_CatalogMutex */
+static FBPDT_Catalog& GetCatalog_NoLock()
+{
+	if (G_BPDT_bCatalogLoaded)
+	{
+		return G_BPDT_Catalog;
+	}
 
-			else
-			{
-				TArray<uint8> Data;
-				Data.SetNumUninitialized(Col.ByteSize);
-				Ar->Serialize(Data.GetData(), Col.ByteSize);
-
-				Row.SetCell(
-					ColIdx,
-					FBPDT_Cell(Col.Type, Data.GetData(), Col.ByteSize)
-				);
-			}
+	G_BPDT_bCatalogLoaded = true;
+
+	// ---- newest complete catalog ----
+	TArray<int64> Versions;
+	FindVersionedFiles(BPDT_CATALOG_PREFIX, TEXT("bin"), Versions);
+
+	for (const int64 Version : Versions)
+	{
+		FBPDT_Catalog Parsed;
+		if (ReadCatalog(GetCatalogPath(Version), Parsed))
+		{
+			G_BPDT_Catalog = MoveTemp(Parsed);
+			MergeCookedTables(G_BPDT_Catalog);
+			return G_BPDT_Catalog;
 		}
 
-		OutTable.InsertRow(Row);
+		UE_LOG(LogTemp, Warning, TEXT("[BPDT] Catalog %lld is damaged; trying the previous one."), Version);
 	}
 
-	return true;
+	// ---- none yet: migrate the registry layout, data files stay where they are ----
+	bool bComplete = false;
+	const bool bMigrated = ReadLegacyLayout(G_BPDT_Catalog, bComplete);
+
+	// Nothing saved yet: a packaged build starts from its cooked tables
+	MergeCookedTables(G_BPDT_Catalog);
+
+	if (!bMigrated)
+	{
+		return G_BPDT_Catalog;
+	}
+
+	G_BPDT_Catalog.Version++;
+
+	if (!PublishCatalog(G_BPDT_Catalog))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[BPDT] Could not write the catalog; the next save retries the migration."));
+		return G_BPDT_Catalog;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("[BPDT] Migrated %d tables to catalog %lld."),
+		G_BPDT_Catalog.Tables.Num(), G_BPDT_Catalog.Version);
+
+	// Keep the old files around if any of them could not be carried over.
+	// Nothing read the old layout yet, so there is no previous catalog to keep.
+	if (bComplete)
+	{
+		CollectGarbage(G_BPDT_Catalog, nullptr);
+	}
+	return G_BPDT_Catalog;
+}
+
+static bool FindCatalogEntry(const FString& TableName, FBPDT_CatalogEntry& OutEntry)
+{
+	FScopeLock Lock(&G_BPDT_CatalogMutex);
 
-}
\ No newline at end of file
+	const FBPDT_CatalogEntry* Entry = GetCatalog_NoLock().Tables.Find(TableName);
+	if (!Entry)
+	{
+		return false;
+	}
+
+	OutEntry = *Entry;
+	return true;
+}
+
+/* ===================== PUBLIC ===================== */
+
+bool FBPDT_FileManager::WriteTable(
+	const FString& TableName,
+	const FBPDT_Table& Table
+)
+{
+	TMap<FString, FBPDT_Table> Tables;
+	Tables.Add(TableName, Table.MakeSnapshot());
+
+	return WriteTables(Tables, nullptr);
+}
+
+bool FBPDT_FileManager::WriteForeignKeys(const TArray<FBPDT_ForeignKeyConstraint>& ForeignKeys)
+{
+	return WriteTables(TMap<FString, FBPDT_Table>(), &ForeignKeys);
+}
+
+bool FBPDT_FileManager::WriteTables(
+	const TMap<FString, FBPDT_Table>& Tables,
+	const TArray<FBPDT_ForeignKeyConstraint>* ForeignKeys,
+	const TSet<FString>* RemovedTables
+)
+{
+	const FString Directory = GetSaveDirectory();
+
+	IPlatformFile& PF =
+		FPlatformFileManager::Get().GetPlatformFile();
+
+	if (!PF.DirectoryExists(*Directory))
+	{
+		PF.CreateDirectoryTree(*Directory);
+	}
+
+	FScopeLock Lock(&G_BPDT_CatalogMutex);
+
+	FBPDT_Catalog Next = GetCatalog_NoLock();
+	Next.Version++;
+
+	// New data files get the catalog version in their name, so they never
+	// collide with a file the published catalog refers to
+	const FString Suffix = FString::Printf(TEXT(".%lld"), Next.Version);
+
+	struct FPendingFile
+	{
+		FString Path;
+		TArray<uint8> Bytes;
+	};
+	TArray<FPendingFile> Pending;
+
+	bool bChanged = ForeignKeys && *ForeignKeys != Next.ForeignKeys;
+
+	// ---- removed tables: their files go once the previous catalog does ----
+	if (RemovedTables)
+	{
+		for (const FString& TableName : *RemovedTables)
+		{
+			if (!Tables.Contains(TableName) && Next.Tables.Remove(TableName) > 0)
+			{
+				bChanged = true;
+			}
+		}
+	}
+
+	// ---- new files are encoded in memory first; appends go past the committed length ----
+	for (const auto& Pair : Tables)
+	{
+		const FString& TableName = Pair.Key;
+		const FBPDT_Table& Table = Pair.Value;
+
+		FBPDT_CatalogEntry* Saved = Next.Tables.Find(TableName);
+
+		const bool bDataExists =
+			Saved &&
+			Saved->Version != 0 &&
+			(Saved->bCooked || PF.FileExists(*(Directory / Saved->DataFile)));
+
+		if (bDataExists && Saved->Version == Table.GetVersion())
+		{
+			UE_LOG(LogTemp, Verbose, TEXT("[BPDT] Table '%s' is clean, nothing to save."), *TableName);
+			continue;
+		}
+
+		bChanged = true;
+
+		FBPDT_CatalogEntry Entry = Saved ? *Saved : FBPDT_CatalogEntry();
+		// Renames keep the layout: the file takes appends, the catalog the names
+		const bool bSchemaClean = bDataExists && Table.GetLayoutVersion() <= Saved->Version;
+
+		// ---- schema: lives in the catalog only ----
+		Entry.PKMode = Table.PKMode;
+		Entry.PKColumnName = Table.GetPKColumnName();
+		Entry.NextSerialID = Table.NextSerialID;
+		Entry.Compression = Table.Compression;
+		Entry.Columns = Table.GetColumns();
+
+		for (FBPDT_Column& Column : Entry.Columns)
+		{
+			Column.bIsForeignKey = false;
+			Column.ReferencedTableName = NAME_None;
+		}
+
+		// Rows only: append past the committed length of the current file.
+		// Until the catalog is published, readers never look past it. Cooked
+		// entries (DataBytes -1) have no file to append to.
+		int64 AppendedBytes = 0;
+		uint32 AppendedCrc = Entry.DataCrc;
+		const bool bAppended =
+			bSchemaClean &&
+			Saved->DataBytes >= 0 &&
+			AppendDirtyRowGroups(
+				Directory / Entry.DataFile,
+				Table,
+				Saved->Version,
+				Saved->RowCount,
+				Saved->DataBytes,
+				AppendedBytes,
+				AppendedCrc
+			);
+
+		if (bAppended)
+		{
+			Entry.DataBytes = AppendedBytes;
+			Entry.DataCrc = AppendedCrc;
+		}
+		else
+		{
+			FPendingFile& Data = Pending.AddDefaulted_GetRef();
+			Entry.DataFile = TableName + TEXT("_Data") + Suffix + TEXT(".bin");
+			Data.Path = Directory / Entry.DataFile;
+			EncodeDataFile(Table, Data.Bytes);
+			Entry.DataBytes = Data.Bytes.Num();
+			Entry.DataCrc = DataCrc32(Data.Bytes.GetData(), Data.Bytes.Num());
+			Entry.bCooked = false;
+		}
+
+		Entry.RowCount = Table.GetRowCount();
+		Entry.Version = Table.GetVersion();
+		Next.Tables.Add(TableName, MoveTemp(Entry));
+	}
+
+	if (ForeignKeys)
+	{
+		Next.ForeignKeys = *ForeignKeys;
+	}
+
+	// Every table clean and the same FKs: the published catalog still holds
+	if (!bChanged)
+	{
+		return true;
+	}
+
+	// ---- write new files back to back, one write and flush each, then publish ----
+	for (const FPendingFile& File : Pending)
+	{
+		if (!WriteFileBytes(File.Path, File.Bytes))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[BPDT] Failed to write '%s'; save not published."), *File.Path);
+			return false;
+		}
+	}
+
+	if (!PublishCatalog(Next))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[BPDT] Failed to publish catalog %lld."), Next.Version);
+		return false;
+	}
+
+	FBPDT_Catalog Previous = MoveTemp(G_BPDT_Catalog);
+	G_BPDT_Catalog = MoveTemp(Next);
+	CollectGarbage(G_BPDT_Catalog, &Previous);
+	return true;
+}
+
+bool FBPDT_FileManager::ReadRegistry(TArray<FString>& OutTableNames)
+{
+	FScopeLock Lock(&G_BPDT_CatalogMutex);
+
+	GetCatalog_NoLock().Tables.GetKeys(OutTableNames);
+	return true;
+}
+
+bool FBPDT_FileManager::IsTableInRegistry(const FString& TableName)
+{
+	FScopeLock Lock(&G_BPDT_CatalogMutex);
+
+	return GetCatalog_NoLock().Tables.Contains(TableName);
+}
+
+bool FBPDT_FileManager::ReadForeignKeys(TArray<FBPDT_ForeignKeyConstraint>& OutForeignKeys)
+{
+	FScopeLock Lock(&G_BPDT_CatalogMutex);
+
+	OutForeignKeys = GetCatalog_NoLock().ForeignKeys;
+	return true;
+}
+
+bool FBPDT_FileManager::IsTableCooked(const FString& TableName)
+{
+	FScopeLock Lock(&G_BPDT_CatalogMutex);
+
+	const FBPDT_CatalogEntry* Entry = GetCatalog_NoLock().Tables.Find(TableName);
+	return Entry && Entry->bCooked;
+}
+
+bool FBPDT_FileManager::FindCookedRow(const FString& TableName, const FString& PKValue, int32& OutRowIndex)
+{
+	return IsTableCooked(TableName) &&
+		FBPDT_CookedTables::Get().FindRow(TableName, PKValue, OutRowIndex);
+}
+
+bool FBPDT_FileManager::IsTableSaved(const FString& TableName, uint64 Version)
+{
+	FScopeLock Lock(&G_BPDT_CatalogMutex);
+
+	const FBPDT_CatalogEntry* Entry = GetCatalog_NoLock().Tables.Find(TableName);
+	return Entry && Entry->Version != 0 && Entry->Version == Version;
+}
+
+void FBPDT_FileManager::NoteTableUnchanged(const FString& TableName, uint64 FilesVersion, uint64 NewVersion)
+{
+	FScopeLock Lock(&G_BPDT_CatalogMutex);
+
+	FBPDT_CatalogEntry* Entry = GetCatalog_NoLock().Tables.Find(TableName);
+	if (Entry && Entry->Version != 0 && Entry->Version == FilesVersion)
+	{
+		Entry->Version = NewVersion;
+	}
+}
+
+/* ===================== INTERNAL ===================== */
+
+FString FBPDT_FileManager::GetSaveDirectory()
+{
+	return FPaths::ProjectSavedDir() / TEXT("Plugins/BPDT");
+}
+
+
+/* ===================== DATA ===================== */
+
+
+/*
+ * v2 / v3 layout
+ *
+ *   header   magic, version, row count, column count, rows per group (uint32 each)
+ *   chunks   for each row group, for each column: FBPDT_ColumnChunk (v2),
+ *            or a block holding one (v3)
+ *   footer   for each row group, for each column: offset (uint64) + size (uint32)
+ *   tail     footer offset (uint64), magic (uint32)
+ *
+ * The footer lets a reader go straight to the chunks of the columns it needs.
+ * Incremental saves append chunks, footer and tail; the row count and length
+ * that count are the ones in the catalog, not the header's.
+ *
+ * A v3 block is the EBPDT_Compression of its payload and the chunk size
+ * (uint32 each), then the chunk, compressed with that codec unless it is
+ * None. Blocks are compressed on their own, so any one of them can still be
+ * read without the rest, and a block that would not shrink is stored as is.
+ */
+
+static FName GetCompressionFormat(EBPDT_Compression Compression)
+{
+	switch (Compression)
+	{
+	case EBPDT_Compression::Zlib:  return NAME_Zlib;
+	case EBPDT_Compression::LZ4:   return NAME_LZ4;
+	case EBPDT_Compression::Oodle: return NAME_Oodle;
+	default:                       return NAME_None;
+	}
+}
+
+/* Turns an encoded chunk into a v3 block */
+static void EncodeBlock(EBPDT_Compression Compression, TArray<uint8>& InOutChunk)
+{
+	const int32 RawBytes = InOutChunk.Num();
+	const FName Format = GetCompressionFormat(Compression);
+
+	TArray<uint8> Block;
+	uint32 Method = (uint32)EBPDT_Compression::None;
+
+	if (!Format.IsNone() && RawBytes > 0)
+	{
+		int32 CompressedBytes = FCompression::CompressMemoryBound(Format, RawBytes);
+		Block.SetNumUninitialized(BPDT_BLOCK_HEADER_BYTES + CompressedBytes);
+
+		if (FCompression::CompressMemory(
+				Format,
+				Block.GetData() + BPDT_BLOCK_HEADER_BYTES,
+				CompressedBytes,
+				InOutChunk.GetData(),
+				RawBytes) &&
+			CompressedBytes < RawBytes)
+		{
+			Method = (uint32)Compression;
+			Block.SetNum(BPDT_BLOCK_HEADER_BYTES + CompressedBytes, EAllowShrinking::No);
+		}
+	}
+
+	if (Method == (uint32)EBPDT_Compression::None)
+	{
+		Block.SetNumUninitialized(BPDT_BLOCK_HEADER_BYTES + RawBytes);
+		FMemory::Memcpy(Block.GetData() + BPDT_BLOCK_HEADER_BYTES, InOutChunk.GetData(), RawBytes);
+	}
+
+	const uint32 BinRawBytes = (uint32)RawBytes;
+	FMemory::Memcpy(Block.GetData(), &Method, sizeof(uint32));
+	FMemory::Memcpy(Block.GetData() + sizeof(uint32), &BinRawBytes, sizeof(uint32));
+
+	InOutChunk = MoveTemp(Block);
+}
+
+/**
+ * Finds the chunk inside a v3 block. Stored blocks point into Data;
+ * compressed ones are inflated into Scratch.
+ */
+static bool DecodeBlock(
+	const uint8* Data,
+	int64 Size,
+	TArray<uint8>& Scratch,
+	const uint8*& OutChunk,
+	int64& OutChunkSize
+)
+{
+	if (Size < BPDT_BLOCK_HEADER_BYTES)
+	{
+		return false;
+	}
+
+	uint32 Method = 0;
+	uint32 RawBytes = 0;
+	FMemory::Memcpy(&Method, Data, sizeof(uint32));
+	FMemory::Memcpy(&RawBytes, Data + sizeof(uint32), sizeof(uint32));
+
+	const uint8* Payload = Data + BPDT_BLOCK_HEADER_BYTES;
+	const int64 PayloadBytes = Size - BPDT_BLOCK_HEADER_BYTES;
+
+	if (Method == (uint32)EBPDT_Compression::None)
+	{
+		OutChunk = Payload;
+		OutChunkSize = PayloadBytes;
+		return PayloadBytes == RawBytes;
+	}
+
+	const FName Format = GetCompressionFormat((EBPDT_Compression)Method);
+	if (Format.IsNone() || RawBytes > (uint32)MAX_int32)
+	{
+		return false;
+	}
+
+	Scratch.SetNumUninitialized((int32)RawBytes, EAllowShrinking::No);
+	if (!FCompression::UncompressMemory(Format, Scratch.GetData(), (int32)RawBytes, Payload, PayloadBytes))
+	{
+		return false;
+	}
+
+	OutChunk = Scratch.GetData();
+	OutChunkSize = RawBytes;
+	return true;
+}
+
+/* Where the chunk of one column of one row group is, from the footer directory */
+static void ReadChunkEntry(
+	const uint8* Footer,
+	int32 ColumnCount,
+	int32 Group,
+	int32 ColIdx,
+	uint64& OutOffset,
+	uint32& OutSize
+)
+{
+	const uint8* Entry = Footer + ((int64)Group * ColumnCount + ColIdx) * BPDT_CHUNK_ENTRY_BYTES;
+
+	FMemory::Memcpy(&OutOffset, Entry, sizeof(uint64));
+	FMemory::Memcpy(&OutSize, Entry + sizeof(uint64), sizeof(uint32));
+}
+
+/* Decodes the GroupRows cells of one chunk (a v3 block when bBlocks), in row order */
+static bool DecodeGroupChunk(
+	const uint8* Data,
+	int64 Size,
+	bool bBlocks,
+	const FBPDT_Column& Column,
+	int32 GroupRows,
+	TFunctionRef<void(int32 RowInGroup, FBPDT_Cell&& Cell)> Emit
+)
+{
+	const uint8* Chunk = Data;
+	int64 ChunkBytes = Size;
+	TArray<uint8> Scratch;
+
+	if (bBlocks && !DecodeBlock(Data, Size, Scratch, Chunk, ChunkBytes))
+	{
+		return false;
+	}
+
+	int32 Emitted = 0;
+	const bool bOk = FBPDT_ColumnChunk::Decode(Chunk, ChunkBytes, Column.Type, Column.ByteSize,
+		[&](int32 RowInChunk, FBPDT_Cell&& Cell)
+		{
+			if (RowInChunk < GroupRows)
+			{
+				Emit(RowInChunk, MoveTemp(Cell));
+				++Emitted;
+			}
+		});
+
+	return bOk && Emitted == GroupRows;
+}
+
+void FBPDT_FileManager::EncodeRowGroups(
+	const FBPDT_Table& Table,
+	const TArray<int32>& Groups,
+	TArray<TArray<uint8>>& OutChunks
+)
+{
+	const TArray<FBPDT_Column>& Columns = Table.GetColumns();
+	const int32 ColumnCount = Columns.Num();
+	const int32 RowCount = Table.GetRowCount();
+
+	// One task per chunk; OutChunks[i * ColumnCount + c] is column c of Groups[i]
+	OutChunks.SetNum(Groups.Num() * ColumnCount);
+
+	ParallelFor(OutChunks.Num(), [&](int32 ChunkIndex)
+	{
+		const int32 Group = Groups[ChunkIndex / ColumnCount];
+		const int32 ColIdx = ChunkIndex % ColumnCount;
+
+		const int32 Begin = Group * BPDT_ROWS_PER_GROUP;
+		const int32 End = FMath::Min(Begin + BPDT_ROWS_PER_GROUP, RowCount);
+
+		FBPDT_ColumnChunk::Encode(
+			Columns[ColIdx].Type,
+			Columns[ColIdx].ByteSize,
+			End - Begin,
+			[&](int32 RowInChunk) -> const FBPDT_Cell&
+			{
+				return Table.GetCellAt(Begin + RowInChunk, ColIdx);
+			},
+			OutChunks[ChunkIndex]
+		);
+
+		// Compressed inside the same task, so blocks compress in parallel too
+		EncodeBlock(Table.Compression, OutChunks[ChunkIndex]);
+	});
+}
+
+void FBPDT_FileManager::EncodeDataFile(
+	const FBPDT_Table& Table,
+	TArray<uint8>& Out
+)
+{
+	FMemoryWriter Ar(Out);
+
+	const int32 ColumnCount = Table.GetColumns().Num();
+	const int32 RowCount = Table.GetRowCount();
+	const int32 GroupCount = (RowCount + BPDT_ROWS_PER_GROUP - 1) / BPDT_ROWS_PER_GROUP;
+
+	// ---- encode every chunk in parallel ----
+	TArray<int32> Groups;
+	for (int32 Group = 0; Group < GroupCount; ++Group)
+	{
+		Groups.Add(Group);
+	}
+
+	TArray<TArray<uint8>> Chunks;
+	EncodeRowGroups(Table, Groups, Chunks);
+
+	// ---- write header, chunks, footer ----
+	uint32 Magic = BPDT_DATA_MAGIC;
+	uint32 Version = BPDT_DATA_VERSION;
+	uint32 BinRowCount = (uint32)RowCount;
+	uint32 BinColCount = (uint32)ColumnCount;
+	uint32 RowsPerGroup = (uint32)BPDT_ROWS_PER_GROUP;
+
+	Ar << Magic;
+	Ar << Version;
+	Ar << BinRowCount;
+	Ar << BinColCount;
+	Ar << RowsPerGroup;
+
+	TArray<uint64> Offsets;
+	Offsets.SetNum(Chunks.Num());
+
+	for (int32 i = 0; i < Chunks.Num(); ++i)
+	{
+		Offsets[i] = (uint64)Ar.Tell();
+		Ar.Serialize(Chunks[i].GetData(), Chunks[i].Num());
+	}
+
+	uint64 FooterOffset = (uint64)Ar.Tell();
+
+	for (int32 i = 0; i < Chunks.Num(); ++i)
+	{
+		uint32 ChunkSize = (uint32)Chunks[i].Num();
+		Ar << Offsets[i];
+		Ar << ChunkSize;
+	}
+
+	Ar << FooterOffset;
+	Ar << Magic;
+}
+
+bool FBPDT_FileManager::AppendDirtyRowGroups(
+	const FString& Path,
+	const FBPDT_Table& Table,
+	uint64 SavedVersion,
+	int32 SavedRowCount,
+	int64 SavedBytes,
+	int64& OutBytes,
+	uint32& InOutCrc
+)
+{
+	IPlatformFile& PF =
+		FPlatformFileManager::Get().GetPlatformFile();
+
+	// Append mode keeps the contents; the handle still seeks for reads
+	TUniquePtr<IFileHandle> File(PF.OpenWrite(*Path, /*bAppend*/ true, /*bAllowRead*/ true));
+	if (!File)
+	{
+		return false;
+	}
+
+	const int32 ColumnCount = Table.GetColumns().Num();
+	const int32 RowCount = Table.GetRowCount();
+
+	// Committed length; bytes past it are left over from an unpublished save
+	const int64 FileSize = SavedBytes >= 0 ? SavedBytes : File->Size();
+	if (File->Size() < FileSize)
+	{
+		return false;
+	}
+
+	// ---- current header and directory ----
+	if (FileSize < BPDT_DATA_HEADER_BYTES + BPDT_DATA_TAIL_BYTES)
+	{
+		return false;
+	}
+
+	uint32 Header[5];
+	if (!File->Seek(0) || !File->Read(reinterpret_cast<uint8*>(Header), sizeof(Header)))
+	{
+		return false;
+	}
+
+	// The header keeps the row count of the full write; appends don't touch it
+	const int32 OldRowCount = SavedRowCount;
+
+	if (Header[0] != BPDT_DATA_MAGIC ||
+		Header[1] != BPDT_DATA_VERSION ||
+		(int32)Header[2] > OldRowCount ||
+		(int32)Header[3] != ColumnCount ||
+		(int32)Header[4] != BPDT_ROWS_PER_GROUP ||
+		OldRowCount > RowCount)
+	{
+		return false;
+	}
+
+	uint8 Tail[BPDT_DATA_TAIL_BYTES];
+	if (!File->Seek(FileSize - BPDT_DATA_TAIL_BYTES) || !File->Read(Tail, sizeof(Tail)))
+	{
+		return false;
+	}
+
+	uint64 OldFooterOffset = 0;
+	uint32 TailMagic = 0;
+	FMemory::Memcpy(&OldFooterOffset, Tail, sizeof(uint64));
+	FMemory::Memcpy(&TailMagic, Tail + sizeof(uint64), sizeof(uint32));
+
+	const int32 OldGroupCount = (OldRowCount + BPDT_ROWS_PER_GROUP - 1) / BPDT_ROWS_PER_GROUP;
+	const int64 OldFooterBytes = (int64)OldGroupCount * ColumnCount * BPDT_CHUNK_ENTRY_BYTES;
+
+	if (TailMagic != BPDT_DATA_MAGIC ||
+		(int64)OldFooterOffset + OldFooterBytes != FileSize - BPDT_DATA_TAIL_BYTES)
+	{
+		return false;
+	}
+
+	TArray<uint8> OldFooter;
+	OldFooter.SetNumUninitialized((int32)OldFooterBytes);
+	if (!File->Seek(OldFooterOffset) || !File->Read(OldFooter.GetData(), OldFooterBytes))
+	{
+		return false;
+	}
+
+	// ---- dirty groups: touched since the save, or not on disk yet ----
+	const int32 GroupCount = (RowCount + BPDT_ROWS_PER_GROUP - 1) / BPDT_ROWS_PER_GROUP;
+
+	TArray<int32> DirtyGroups;
+	for (int32 Group = 0; Group < GroupCount; ++Group)
+	{
+		if (Group >= OldGroupCount || Table.GetRowGroupVersion(Group) > SavedVersion)
+		{
+			DirtyGroups.Add(Group);
+		}
+	}
+
+	TArray<TArray<uint8>> Chunks;
+	EncodeRowGroups(Table, DirtyGroups, Chunks);
+
+	// ---- new directory: clean groups keep their chunks ----
+	TArray<uint64> Offsets;
+	TArray<uint32> Sizes;
+	Offsets.SetNumZeroed(GroupCount * ColumnCount);
+	Sizes.SetNumZeroed(GroupCount * ColumnCount);
+
+	for (int32 i = 0; i < OldGroupCount * ColumnCount; ++i)
+	{
+		FMemory::Memcpy(&Offsets[i], &OldFooter[i * BPDT_CHUNK_ENTRY_BYTES], sizeof(uint64));
+		FMemory::Memcpy(&Sizes[i], &OldFooter[i * BPDT_CHUNK_ENTRY_BYTES + sizeof(uint64)], sizeof(uint32));
+	}
+
+	int64 AppendOffset = FileSize;
+	for (int32 i = 0; i < DirtyGroups.Num(); ++i)
+	{
+		for (int32 ColIdx = 0; ColIdx < ColumnCount; ++ColIdx)
+		{
+			const int32 Entry = DirtyGroups[i] * ColumnCount + ColIdx;
+			const TArray<uint8>& Chunk = Chunks[i * ColumnCount + ColIdx];
+
+			Offsets[Entry] = (uint64)AppendOffset;
+			Sizes[Entry] = (uint32)Chunk.Num();
+			AppendOffset += Chunk.Num();
+		}
+	}
+
+	// ---- too much garbage: let the caller rewrite (compact) the file ----
+	const int64 FooterBytes = (int64)GroupCount * ColumnCount * BPDT_CHUNK_ENTRY_BYTES;
+	const int64 FinalSize = AppendOffset + FooterBytes + BPDT_DATA_TAIL_BYTES;
+
+	int64 LiveBytes = BPDT_DATA_HEADER_BYTES + FooterBytes + BPDT_DATA_TAIL_BYTES;
+	for (const uint32 ChunkSize : Sizes)
+	{
+		LiveBytes += ChunkSize;
+	}
+
+	if (FinalSize - LiveBytes > LiveBytes * BPDT_COMPACT_GARBAGE_RATIO)
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("[BPDT] Compacting '%s'."), *Path);
+		return false;
+	}
+
+	// ---- append chunks, footer and tail ----
+	TArray<uint8> Footer;
+	Footer.Reserve((int32)(FooterBytes + BPDT_DATA_TAIL_BYTES));
+	for (int32 i = 0; i < Offsets.Num(); ++i)
+	{
+		Footer.Append(reinterpret_cast<const uint8*>(&Offsets[i]), sizeof(uint64));
+		Footer.Append(reinterpret_cast<const uint8*>(&Sizes[i]), sizeof(uint32));
+	}
+
+	const uint64 FooterOffset = (uint64)AppendOffset;
+	const uint32 Magic = BPDT_DATA_MAGIC;
+	Footer.Append(reinterpret_cast<const uint8*>(&FooterOffset), sizeof(uint64));
+	Footer.Append(reinterpret_cast<const uint8*>(&Magic), sizeof(uint32));
+
+	if (!File->Seek(FileSize))
+	{
+		return false;
+	}
+
+	for (const TArray<uint8>& Chunk : Chunks)
+	{
+		if (!File->Write(Chunk.GetData(), Chunk.Num()))
+		{
+			return false;
+		}
+	}
+
+	if (!File->Write(Footer.GetData(), Footer.Num()) ||
+		!File->Flush(/*bFullFlush*/ true))
+	{
+		return false;
+	}
+
+	OutBytes = FinalSize;
+
+	// Appended right at the committed length: the CRC carries on over it
+	for (const TArray<uint8>& Chunk : Chunks)
+	{
+		InOutCrc = DataCrc32(Chunk.GetData(), Chunk.Num(), InOutCrc);
+	}
+	InOutCrc = DataCrc32(Footer.GetData(), Footer.Num(), InOutCrc);
+
+	UE_LOG(LogTemp, Verbose, TEXT("[BPDT] '%s': wrote %d of %d row groups."),
+		*Path, DirtyGroups.Num(), GroupCount);
+	return true;
+}
+
+/* A cooked entry: the rows are copied out of the mapped cook, nothing to decode */
+static bool ReadCookedTable(
+	const FString& TableName,
+	const FBPDT_CatalogEntry& Entry,
+	FBPDT_Table& OutTable
+)
+{
+	const FBPDT_CookedTables& Cooked = FBPDT_CookedTables::Get();
+	const int32 ColumnCount = Entry.Columns.Num();
+
+	TArray<FBPDT_Row> Rows;
+	Rows.SetNum(Entry.RowCount);
+	for (FBPDT_Row& Row : Rows)
+	{
+		Row.Cells.SetNum(ColumnCount);
+	}
+
+	std::atomic<bool> bFailed{ false };
+	ParallelFor(ColumnCount, [&](int32 ColIndex)
+	{
+		TArray<FBPDT_Cell> Cells;
+		if (!Cooked.ReadCells(TableName, ColIndex, 0, Entry.RowCount, Cells))
+		{
+			bFailed = true;
+			return;
+		}
+
+		for (int32 RowIndex = 0; RowIndex < Cells.Num(); ++RowIndex)
+		{
+			Rows[RowIndex].Cells[ColIndex] = MoveTemp(Cells[RowIndex]);
+		}
+	});
+
+	if (bFailed)
+	{
+		return false;
+	}
+
+	OutTable = FBPDT_Table();
+	OutTable.InitSchema(Entry.PKMode, Entry.PKColumnName, Entry.Columns, Entry.NextSerialID);
+	OutTable.Compression = Entry.Compression;
+
+	if (!OutTable.AppendRows(MoveTemp(Rows)))
+	{
+		return false;
+	}
+
+	// Matches the cook until the first write
+	{
+		FScopeLock Lock(&G_BPDT_CatalogMutex);
+
+		FBPDT_CatalogEntry* Published = GetCatalog_NoLock().Tables.Find(TableName);
+		if (Published && Published->bCooked)
+		{
+			Published->Version = OutTable.GetVersion();
+		}
+	}
+
+	return true;
+}
+
+bool FBPDT_FileManager::ReadTable(
+	const FString& TableName,
+	FBPDT_Table& OutTable
+)
+{
+	FBPDT_CatalogEntry Entry;
+	if (!FindCatalogEntry(TableName, Entry))
+	{
+		return false;
+	}
+
+	if (Entry.bCooked)
+	{
+		return ReadCookedTable(TableName, Entry, OutTable);
+	}
+
+	const FString DataPath = GetSaveDirectory() / Entry.DataFile;
+
+	/* ---------- INIT TABLE ---------- */
+
+	OutTable = FBPDT_Table();
+	OutTable.InitSchema(Entry.PKMode, Entry.PKColumnName, Entry.Columns, Entry.NextSerialID);
+	OutTable.Compression = Entry.Compression;
+
+	/* ---------- READ DATA ---------- */
+
+	TArray<FBPDT_Row> Rows;
+	int64 DataBytes = Entry.DataBytes;
+	uint32 DataCrc = Entry.DataCrc;
+
+	// Migrated entries have no CRC yet; this read supplies it
+	auto MatchesCatalog = [&]()
+	{
+		if (Entry.DataBytes >= 0 && DataCrc != Entry.DataCrc)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[BPDT] '%s' does not match its catalog checksum."), *DataPath);
+			return false;
+		}
+		return true;
+	};
+
+	// Row groups decode while the rest of the file is still being read;
+	// the checksum is only known once the last byte is in
+	bool bStreamed = false;
+	bool bDecoded = CVarBPDTPrefetchLoad.GetValueOnAnyThread() &&
+		StreamDataFile(DataPath, Entry.DataBytes, Entry.Columns, Entry.RowCount, Rows, DataBytes, DataCrc, bStreamed) &&
+		MatchesCatalog();
+
+	if (!bStreamed)
+	{
+		bDecoded = MapFile(DataPath, Entry.DataBytes,
+			[&](const uint8* Data, int64 Size)
+			{
+				DataBytes = Size;
+				DataCrc = DataCrc32(Data, Size);
+
+				return MatchesCatalog() &&
+					DecodeDataFile(Data, Size, Entry.Columns, Entry.RowCount, INDEX_NONE, Rows);
+			});
+	}
+
+	if (!bDecoded || !OutTable.AppendRows(MoveTemp(Rows)))
+	{
+		return false;
+	}
+
+	// What was just read is what is on disk, unless a save published meanwhile
+	{
+		FScopeLock Lock(&G_BPDT_CatalogMutex);
+
+		FBPDT_CatalogEntry* Published = GetCatalog_NoLock().Tables.Find(TableName);
+		if (Published &&
+			Published->DataFile == Entry.DataFile &&
+			Published->DataBytes == Entry.DataBytes)
+		{
+			Published->DataBytes = DataBytes;
+			Published->DataCrc = DataCrc;
+			Published->Version = OutTable.GetVersion();
+		}
+	}
+
+	return true;
+}
+
+bool FBPDT_FileManager::ReadColumn(
+	const FString& TableName,
+	FName ColumnName,
+	TArray<FBPDT_Cell>& OutCells
+)
+{
+	FBPDT_CatalogEntry Entry;
+	if (!FindCatalogEntry(TableName, Entry))
+	{
+		return false;
+	}
+
+	const int32 ColIdx = Entry.Columns.IndexOfByPredicate(
+		[ColumnName](const FBPDT_Column& Col) { return Col.Name == ColumnName; });
+
+	if (ColIdx == INDEX_NONE)
+	{
+		return false;
+	}
+
+	if (Entry.bCooked)
+	{
+		return FBPDT_CookedTables::Get().ReadCells(TableName, ColIdx, 0, Entry.RowCount, OutCells);
+	}
+
+	// v2 files decode only this column's chunks; each row holds just that cell.
+	// The CRC covers the whole file, so a partial read goes by the footer checks.
+	TArray<FBPDT_Row> Rows;
+	const bool bDecoded = MapFile(GetSaveDirectory() / Entry.DataFile, Entry.DataBytes,
+		[&](const uint8* Data, int64 Size)
+		{
+			return DecodeDataFile(Data, Size, Entry.Columns, Entry.RowCount, ColIdx, Rows);
+		});
+
+	if (!bDecoded)
+	{
+		return false;
+	}
+
+	OutCells.Reset(Rows.Num());
+	for (FBPDT_Row& Row : Rows)
+	{
+		OutCells.Add(MoveTemp(Row.Cells[Row.Num() == 1 ? 0 : ColIdx]));
+	}
+	return true;
+}
+
+bool FBPDT_FileManager::ReadSavedSchema(
+	const FString& TableName,
+	TArray<FBPDT_Column>& OutColumns,
+	FName& OutPKColumnName,
+	int32& OutRowCount
+)
+{
+	FScopeLock Lock(&G_BPDT_CatalogMutex);
+
+	const FBPDT_CatalogEntry* Entry = GetCatalog_NoLock().Tables.Find(TableName);
+	if (!Entry)
+	{
+		return false;
+	}
+
+	OutColumns = Entry->Columns;
+	OutPKColumnName = Entry->PKColumnName;
+	OutRowCount = Entry->RowCount;
+	return true;
+}
+
+bool FBPDT_FileManager::ReadColumnPage(
+	const FString& TableName,
+	int32 ColumnIndex,
+	int32 Group,
+	FBPDT_PageRef& OutPage
+)
+{
+	return ReadColumnPages(TableName, ColumnIndex, Group, 1,
+		[&OutPage](int32, const FBPDT_PageRef& Page)
+		{
+			OutPage = Page;
+			return true;
+		});
+}
+
+bool FBPDT_FileManager::ReadColumnPages(
+	const FString& TableName,
+	int32 ColumnIndex,
+	int32 FirstGroup,
+	int32 NumGroups,
+	TFunctionRef<bool(int32 Group, const FBPDT_PageRef& Page)> Use
+)
+{
+	FBPDT_PageKey Key;
+	FBPDT_Column Column;
+	int32 ColumnCount = 0;
+	int32 RowCount = 0;
+	bool bCooked = false;
+	{
+		FScopeLock Lock(&G_BPDT_CatalogMutex);
+
+		const FBPDT_CatalogEntry* Entry = GetCatalog_NoLock().Tables.Find(TableName);
+		if (!Entry || !Entry->Columns.IsValidIndex(ColumnIndex) || (!Entry->bCooked && Entry->DataBytes < 0))
+		{
+			return false;
+		}
+
+		bCooked = Entry->bCooked;
+
+		Key.DataFile = Entry->DataFile;
+		Key.DataBytes = Entry->DataBytes;
+		Key.Column = ColumnIndex;
+
+		Column = Entry->Columns[ColumnIndex];
+		ColumnCount = Entry->Columns.Num();
+		RowCount = Entry->RowCount;
+	}
+
+	const int32 GroupCount = (RowCount + BPDT_ROWS_PER_GROUP - 1) / BPDT_ROWS_PER_GROUP;
+	if (FirstGroup < 0 || NumGroups < 0 || FirstGroup + NumGroups > GroupCount)
+	{
+		return false;
+	}
+
+	auto GetGroupRows = [RowCount](int32 Group)
+	{
+		return FMath::Min(BPDT_ROWS_PER_GROUP, RowCount - Group * BPDT_ROWS_PER_GROUP);
+	};
+
+	// Cooked rows are mapped already; a pool copy would only cost memory
+	if (bCooked)
+	{
+		for (int32 Group = FirstGroup; Group < FirstGroup + NumGroups; ++Group)
+		{
+			const int32 Begin = Group * BPDT_ROWS_PER_GROUP;
+
+			FBPDT_Page Page;
+			if (!FBPDT_CookedTables::Get().ReadCells(TableName, ColumnIndex, Begin, Begin + GetGroupRows(Group), Page) ||
+				!Use(Group, MakeShared<FBPDT_Page, ESPMode::ThreadSafe>(MoveTemp(Page))))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// ---- pool hits are used as they are; only misses touch the file ----
+	FBPDT_BufferPool& Pool = FBPDT_BufferPool::Get();
+
+	TArray<FBPDT_PageRef> Hits;
+	TArray<int32> Misses;
+	Hits.SetNum(NumGroups);
+
+	for (int32 Index = 0; Index < NumGroups; ++Index)
+	{
+		Key.Group = FirstGroup + Index;
+		Hits[Index] = Pool.Find(Key);
+		if (!Hits[Index])
+		{
+			Misses.Add(Key.Group);
+		}
+	}
+
+	TUniquePtr<FBPDT_PrefetchReader> Reader;
+	uint32 Version = 0;
+	TArray<uint64> ChunkOffsets;
+	TArray<uint32> ChunkSizes;
+
+	if (Misses.Num() > 0)
+	{
+		// ---- header + tail, then the footer entries of the missing groups ----
+		Reader = MakeUnique<FBPDT_PrefetchReader>(GetSaveDirectory() / Key.DataFile);
+		if (!Reader->IsOpen() || Key.DataBytes < BPDT_DATA_HEADER_BYTES + BPDT_DATA_TAIL_BYTES)
+		{
+			return false;
+		}
+
+		uint32 Header[5];
+		uint8 Tail[BPDT_DATA_TAIL_BYTES];
+		Reader->Prefetch(0, sizeof(Header));
+		Reader->Prefetch(Key.DataBytes - BPDT_DATA_TAIL_BYTES, sizeof(Tail));
+
+		if (!Reader->Next(reinterpret_cast<uint8*>(Header)) ||
+			!Reader->Next(Tail) ||
+			Header[0] != BPDT_DATA_MAGIC ||
+			(Header[1] != BPDT_DATA_VERSION_COLUMNS && Header[1] != BPDT_DATA_VERSION_BLOCKS) ||
+			(int32)Header[3] != ColumnCount ||
+			(int32)Header[4] != BPDT_ROWS_PER_GROUP)
+		{
+			return false;
+		}
+		Version = Header[1];
+
+		uint64 FooterOffset = 0;
+		FMemory::Memcpy(&FooterOffset, Tail, sizeof(uint64));
+
+		// One read spans the directory rows of every missing group
+		const int32 FirstMiss = Misses[0];
+		const int64 SpanOffset = (int64)FooterOffset + (int64)FirstMiss * ColumnCount * BPDT_CHUNK_ENTRY_BYTES;
+		const int64 SpanBytes = (int64)(Misses.Last() - FirstMiss + 1) * ColumnCount * BPDT_CHUNK_ENTRY_BYTES;
+
+		if (SpanOffset + SpanBytes > Key.DataBytes - BPDT_DATA_TAIL_BYTES)
+		{
+			return false;
+		}
+
+		TArray<uint8> Span;
+		Span.SetNumUninitialized(SpanBytes);
+		if (!Reader->Read(SpanOffset, SpanBytes, Span.GetData()))
+		{
+			return false;
+		}
+
+		ChunkOffsets.SetNum(Misses.Num());
+		ChunkSizes.SetNum(Misses.Num());
+		for (int32 Miss = 0; Miss < Misses.Num(); ++Miss)
+		{
+			ReadChunkEntry(Span.GetData(), ColumnCount, Misses[Miss] - FirstMiss, ColumnIndex, ChunkOffsets[Miss], ChunkSizes[Miss]);
+			if (ChunkSizes[Miss] == 0 || ChunkOffsets[Miss] + ChunkSizes[Miss] > FooterOffset)
+			{
+				return false;
+			}
+		}
+	}
+
+	// ---- misses are read BPDT.Prefetch.Depth chunks ahead of their decode ----
+	const int32 Depth = FBPDT_PrefetchReader::GetDepth();
+	int32 NextMiss = 0;
+	int32 Prefetched = 0;
+
+	auto PrefetchUpTo = [&](int32 End)
+	{
+		for (; Prefetched < FMath::Min(End, Misses.Num()); ++Prefetched)
+		{
+			Reader->Prefetch(ChunkOffsets[Prefetched], ChunkSizes[Prefetched]);
+		}
+	};
+
+	TArray<uint8> Bytes;
+	for (int32 Index = 0; Index < NumGroups; ++Index)
+	{
+		const int32 Group = FirstGroup + Index;
+		if (Hits[Index])
+		{
+			if (!Use(Group, Hits[Index]))
+			{
+				return false;
+			}
+			continue;
+		}
+
+		PrefetchUpTo(NextMiss + Depth);
+
+		Bytes.SetNumUninitialized(ChunkSizes[NextMiss], EAllowShrinking::No);
+		if (!Reader->Next(Bytes.GetData()))
+		{
+			return false;
+		}
+		++NextMiss;
+
+		// The next chunk is read while this one decodes
+		PrefetchUpTo(NextMiss + Depth);
+
+		FBPDT_Page Page;
+		Page.SetNum(GetGroupRows(Group));
+
+		if (!DecodeGroupChunk(Bytes.GetData(), Bytes.Num(), Version == BPDT_DATA_VERSION_BLOCKS, Column, Page.Num(),
+				[&Page](int32 RowInGroup, FBPDT_Cell&& Cell) { Page[RowInGroup] = MoveTemp(Cell); }))
+		{
+			return false;
+		}
+
+		Key.Group = Group;
+		if (!Use(Group, Pool.Add(Key, MoveTemp(Page))))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FBPDT_FileManager::MapFile(
+	const FString& Path,
+	int64 Bytes,
+	TFunctionRef<bool(const uint8* Data, int64 Size)> Use
+)
+{
+	IPlatformFile& PF =
+		FPlatformFileManager::Get().GetPlatformFile();
+
+	const int64 FileSize = PF.FileSize(*Path);
+	if (FileSize < 0 || FileSize < Bytes)
+	{
+		return false;
+	}
+
+	const int64 UseBytes = Bytes >= 0 ? Bytes : FileSize;
+
+	// ---- mapped: decode straight from the page cache ----
+	if (CVarBPDTMappedLoad.GetValueOnAnyThread())
+	{
+		FOpenMappedResult Mapped = PF.OpenMappedEx(*Path);
+		if (Mapped.HasValue())
+		{
+			TUniquePtr<IMappedFileHandle> Handle = Mapped.StealValue();
+			TUniquePtr<IMappedFileRegion> Region(
+				Handle->MapRegion(0, UseBytes)
+			);
+
+			if (Region)
+			{
+				return Use(Region->GetMappedPtr(), UseBytes);
+			}
+		}
+	}
+
+	// ---- fallback: one read into memory ----
+	TArray64<uint8> Contents;
+	if (!FFileHelper::LoadFileToArray(Contents, *Path))
+	{
+		return false;
+	}
+
+	return Use(Contents.GetData(), FMath::Min(UseBytes, Contents.Num()));
+}
+
+bool FBPDT_FileManager::StreamDataFile(
+	const FString& Path,
+	int64 Bytes,
+	const TArray<FBPDT_Column>& Columns,
+	int32 RowCount,
+	TArray<FBPDT_Row>& OutRows,
+	int64& OutSize,
+	uint32& OutCrc,
+	bool& bOutStreamed
+)
+{
+	bOutStreamed = false;
+
+	const int64 FileSize = FPlatformFileManager::Get().GetPlatformFile().FileSize(*Path);
+	const int64 Size = Bytes >= 0 ? Bytes : FileSize;
+
+	if (FileSize < Size || Size < BPDT_DATA_HEADER_BYTES + BPDT_DATA_TAIL_BYTES)
+	{
+		return false;
+	}
+
+	FBPDT_PrefetchReader Reader(Path);
+	if (!Reader.IsOpen())
+	{
+		return false;
+	}
+
+	// The whole file ends up in memory, as with a plain read
+	TArray64<uint8> Contents;
+	Contents.SetNumUninitialized(Size);
+	uint8* Data = Contents.GetData();
+
+	// ---- header and tail together ----
+	Reader.Prefetch(0, BPDT_DATA_HEADER_BYTES);
+	Reader.Prefetch(Size - BPDT_DATA_TAIL_BYTES, BPDT_DATA_TAIL_BYTES);
+
+	if (!Reader.Next(Data) || !Reader.Next(Data + Size - BPDT_DATA_TAIL_BYTES))
+	{
+		return false;
+	}
+
+	uint32 Header[5];
+	FMemory::Memcpy(Header, Data, sizeof(Header));
+
+	// v1 has no row groups to stream; the caller reads it whole
+	if (Header[0] != BPDT_DATA_MAGIC ||
+		(Header[1] != BPDT_DATA_VERSION_COLUMNS && Header[1] != BPDT_DATA_VERSION_BLOCKS))
+	{
+		return false;
+	}
+
+	bOutStreamed = true;
+
+	const bool bBlocks = Header[1] == BPDT_DATA_VERSION_BLOCKS;
+	const int32 ColumnCount = Columns.Num();
+	const int32 RowsPerGroup = (int32)Header[4];
+
+	if ((int32)Header[2] > RowCount || (int32)Header[3] != ColumnCount || RowsPerGroup <= 0)
+	{
+		return false;
+	}
+
+	// ---- footer directory ----
+	uint64 FooterOffset = 0;
+	uint32 TailMagic = 0;
+	FMemory::Memcpy(&FooterOffset, Data + Size - BPDT_DATA_TAIL_BYTES, sizeof(uint64));
+	FMemory::Memcpy(&TailMagic, Data + Size - sizeof(uint32), sizeof(uint32));
+
+	const int32 GroupCount = (RowCount + RowsPerGroup - 1) / RowsPerGroup;
+	const int64 FooterBytes = (int64)GroupCount * ColumnCount * BPDT_CHUNK_ENTRY_BYTES;
+
+	if (TailMagic != BPDT_DATA_MAGIC ||
+		(int64)FooterOffset < BPDT_DATA_HEADER_BYTES ||
+		(int64)FooterOffset + FooterBytes != Size - BPDT_DATA_TAIL_BYTES)
+	{
+		return false;
+	}
+
+	if (FooterBytes > 0 && !Reader.Read(FooterOffset, FooterBytes, Data + FooterOffset))
+	{
+		return false;
+	}
+
+	const uint8* Footer = Data + FooterOffset;
+
+	// ---- a row group can be decoded once its last chunk has arrived ----
+	// Appended groups sit past older ones, so go by where each one ends
+	TArray<int64> GroupEnds;
+	GroupEnds.SetNumZeroed(GroupCount);
+
+	for (int32 Group = 0; Group < GroupCount; ++Group)
+	{
+		for (int32 ColIdx = 0; ColIdx < ColumnCount; ++ColIdx)
+		{
+			uint64 ChunkOffset = 0;
+			uint32 ChunkSize = 0;
+			ReadChunkEntry(Footer, ColumnCount, Group, ColIdx, ChunkOffset, ChunkSize);
+
+			if (ChunkOffset < BPDT_DATA_HEADER_BYTES || ChunkOffset + ChunkSize > FooterOffset)
+			{
+				return false;
+			}
+			GroupEnds[Group] = FMath::Max(GroupEnds[Group], (int64)(ChunkOffset + ChunkSize));
+		}
+	}
+
+	TArray<int32> Order;
+	Order.SetNum(GroupCount);
+	for (int32 Group = 0; Group < GroupCount; ++Group)
+	{
+		Order[Group] = Group;
+	}
+	Order.Sort([&GroupEnds](int32 A, int32 B) { return GroupEnds[A] < GroupEnds[B]; });
+
+	OutRows.SetNum(RowCount);
+	for (FBPDT_Row& Row : OutRows)
+	{
+		Row.Cells.SetNum(ColumnCount);
+	}
+
+	// ---- stream the chunks; decode overlaps the reads still in flight ----
+	uint32 Crc = DataCrc32(Data, BPDT_DATA_HEADER_BYTES);
+	int64 CrcEnd = BPDT_DATA_HEADER_BYTES;
+	int32 Decoded = 0;
+
+	auto DecodeReady = [&](int64 ReadyEnd)
+	{
+		Crc = DataCrc32(Data + CrcEnd, ReadyEnd - CrcEnd, Crc);
+		CrcEnd = ReadyEnd;
+
+		int32 ReadyGroups = Decoded;
+		while (ReadyGroups < GroupCount && GroupEnds[Order[ReadyGroups]] <= ReadyEnd)
+		{
+			++ReadyGroups;
+		}
+
+		const int32 First = Decoded;
+		Decoded = ReadyGroups;
+
+		std::atomic<bool> bAllDecoded{ true };
+		ParallelFor((ReadyGroups - First) * ColumnCount, [&](int32 TaskIndex)
+		{
+			const int32 Group = Order[First + TaskIndex / ColumnCount];
+			const int32 ColIdx = TaskIndex % ColumnCount;
+
+			uint64 ChunkOffset = 0;
+			uint32 ChunkSize = 0;
+			ReadChunkEntry(Footer, ColumnCount, Group, ColIdx, ChunkOffset, ChunkSize);
+
+			const int32 Begin = Group * RowsPerGroup;
+			const int32 GroupRows = FMath::Min(RowsPerGroup, RowCount - Begin);
+
+			const bool bOk = DecodeGroupChunk(Data + ChunkOffset, ChunkSize, bBlocks, Columns[ColIdx], GroupRows,
+				[&](int32 RowInGroup, FBPDT_Cell&& Cell)
+				{
+					OutRows[Begin + RowInGroup].Cells[ColIdx] = MoveTemp(Cell);
+				});
+
+			if (!bOk)
+			{
+				bAllDecoded = false;
+			}
+		});
+
+		return bAllDecoded.load();
+	};
+
+	if (FooterOffset > BPDT_DATA_HEADER_BYTES &&
+		!Reader.Stream(BPDT_DATA_HEADER_BYTES, FooterOffset, Data + BPDT_DATA_HEADER_BYTES, DecodeReady))
+	{
+		return false;
+	}
+
+	OutSize = Size;
+	OutCrc = DataCrc32(Data + FooterOffset, Size - FooterOffset, Crc);
+	return true;
+}
+
+bool FBPDT_FileManager::DecodeDataFile(
+	const uint8* Data,
+	int64 Size,
+	const TArray<FBPDT_Column>& Columns,
+	int32 RowCount,
+	int32 OnlyColumn,
+	TArray<FBPDT_Row>& OutRows
+)
+{
+	if (Size < BPDT_DATA_HEADER_BYTES)
+	{
+		return false;
+	}
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	FMemory::Memcpy(&Magic, Data, sizeof(uint32));
+	FMemory::Memcpy(&Version, Data + sizeof(uint32), sizeof(uint32));
+
+	if (Magic != BPDT_DATA_MAGIC)
+	{
+		return false;
+	}
+
+	switch (Version)
+	{
+	case BPDT_DATA_VERSION_ROWS:
+		// Row-major: every column has to be decoded anyway
+		return DecodeRowsV1(Data, Size, Columns, RowCount, OutRows);
+
+	case BPDT_DATA_VERSION_COLUMNS:
+	case BPDT_DATA_VERSION_BLOCKS:
+		return DecodeColumnsV2(Data, Size, Columns, RowCount, OnlyColumn, Version == BPDT_DATA_VERSION_BLOCKS, OutRows);
+
+	default:
+		UE_LOG(LogTemp, Warning, TEXT("[BPDT] Unsupported data file version %u."), Version);
+		return false;
+	}
+}
+
+bool FBPDT_FileManager::DecodeColumnsV2(
+	const uint8* Data,
+	int64 Size,
+	const TArray<FBPDT_Column>& Columns,
+	int32 RowCount,
+	int32 OnlyColumn,
+	bool bBlocks,
+	TArray<FBPDT_Row>& OutRows
+)
+{
+	if (Size < BPDT_DATA_HEADER_BYTES + BPDT_DATA_TAIL_BYTES)
+	{
+		return false;
+	}
+
+	uint32 Header[5];
+	FMemory::Memcpy(Header, Data, sizeof(Header));
+
+	const int32 ColumnCount = Columns.Num();
+	const int32 RowsPerGroup = (int32)Header[4];
+
+	// Header[2] predates any appended row groups
+	if ((int32)Header[2] > RowCount || (int32)Header[3] != ColumnCount || RowsPerGroup <= 0)
+	{
+		return false;
+	}
+
+	// ---- tail -> footer directory ----
+	uint64 FooterOffset = 0;
+	uint32 TailMagic = 0;
+	FMemory::Memcpy(&FooterOffset, Data + Size - BPDT_DATA_TAIL_BYTES, sizeof(uint64));
+	FMemory::Memcpy(&TailMagic, Data + Size - sizeof(uint32), sizeof(uint32));
+
+	const int32 GroupCount = (RowCount + RowsPerGroup - 1) / RowsPerGroup;
+	const int64 FooterBytes = (int64)GroupCount * ColumnCount * BPDT_CHUNK_ENTRY_BYTES;
+
+	if (TailMagic != BPDT_DATA_MAGIC ||
+		(int64)FooterOffset + FooterBytes != Size - BPDT_DATA_TAIL_BYTES)
+	{
+		return false;
+	}
+
+	const uint8* Footer = Data + FooterOffset;
+
+	// ---- rows are pre-sized, chunks fill disjoint cells ----
+	const int32 CellsPerRow = OnlyColumn == INDEX_NONE ? ColumnCount : 1;
+
+	OutRows.SetNum(RowCount);
+	for (FBPDT_Row& Row : OutRows)
+	{
+		Row.Cells.SetNum(CellsPerRow);
+	}
+
+	const int32 ChunksPerGroup = OnlyColumn == INDEX_NONE ? ColumnCount : 1;
+	std::atomic<bool> bAllDecoded{ true };
+
+	ParallelFor(GroupCount * ChunksPerGroup, [&](int32 TaskIndex)
+	{
+		const int32 Group = TaskIndex / ChunksPerGroup;
+		const int32 ColIdx = OnlyColumn == INDEX_NONE ? TaskIndex % ChunksPerGroup : OnlyColumn;
+		const int32 CellIdx = OnlyColumn == INDEX_NONE ? ColIdx : 0;
+
+		uint64 ChunkOffset = 0;
+		uint32 ChunkSize = 0;
+		ReadChunkEntry(Footer, ColumnCount, Group, ColIdx, ChunkOffset, ChunkSize);
+
+		if (ChunkOffset + ChunkSize > FooterOffset)
+		{
+			bAllDecoded = false;
+			return;
+		}
+
+		const int32 Begin = Group * RowsPerGroup;
+		const int32 GroupRows = FMath::Min(RowsPerGroup, RowCount - Begin);
+
+		// v3: every task inflates its own block
+		const bool bOk = DecodeGroupChunk(Data + ChunkOffset, ChunkSize, bBlocks, Columns[ColIdx], GroupRows,
+			[&](int32 RowInGroup, FBPDT_Cell&& Cell)
+			{
+				OutRows[Begin + RowInGroup].Cells[CellIdx] = MoveTemp(Cell);
+			});
+
+		if (!bOk)
+		{
+			bAllDecoded = false;
+		}
+	});
+
+	return bAllDecoded;
+}
+
+bool FBPDT_FileManager::DecodeRowsV1(
+	const uint8* Data,
+	int64 Size,
+	const TArray<FBPDT_Column>& Columns,
+	int32 RowCount,
+	TArray<FBPDT_Row>& OutRows
+)
+{
+	if (Size < BPDT_DATA_HEADER_BYTES)
+	{
+		return false;
+	}
+
+	// magic, version, row count, column count, bytes per row
+	uint32 Header[5];
+	FMemory::Memcpy(Header, Data, sizeof(Header));
+
+	const uint32 BinRowCount = Header[2];
+	const uint32 BinColCount = Header[3];
+	const uint32 BinBytesPerRow = Header[4];
+
+	const int32 ColumnCount = Columns.Num();
+	if ((int32)BinRowCount != RowCount || (int32)BinColCount != ColumnCount)
+	{
+		return false;
+	}
+
+	// ---- fixed row layout: null mask, then every column at a fixed offset ----
+	const int32 NullMaskBytes = (ColumnCount + 7) / 8;
+
+	TArray<int32> ColumnOffsets;
+	ColumnOffsets.SetNum(ColumnCount);
+
+	int32 Stride = NullMaskBytes;
+	for (int32 ColIdx = 0; ColIdx < ColumnCount; ++ColIdx)
+	{
+		ColumnOffsets[ColIdx] = Stride;
+		Stride += Columns[ColIdx].ByteSize;
+	}
+
+	if ((uint32)Stride != BinBytesPerRow ||
+		BPDT_DATA_HEADER_BYTES + (int64)Stride * RowCount > Size)
+	{
+		return false;
+	}
+
+	const uint8* RowData = Data + BPDT_DATA_HEADER_BYTES;
+
+	// Rows are independent and fixed-width: decode in parallel chunks.
+	// Each cell is built once, directly from the file bytes.
+	OutRows.SetNum(RowCount);
+
+	const int32 TaskCount =
+		(RowCount + BPDT_LOAD_ROWS_PER_TASK - 1) / BPDT_LOAD_ROWS_PER_TASK;
+
+	ParallelFor(TaskCount, [&](int32 TaskIndex)
+	{
+		const int32 Begin = TaskIndex * BPDT_LOAD_ROWS_PER_TASK;
+		const int32 End = FMath::Min(Begin + BPDT_LOAD_ROWS_PER_TASK, RowCount);
+
+		for (int32 RowIdx = Begin; RowIdx < End; ++RowIdx)
+		{
+			const uint8* Src = RowData + (int64)RowIdx * Stride;
+
+			TArray<FBPDT_Cell>& Cells = OutRows[RowIdx].Cells;
+			Cells.Reserve(ColumnCount);
+
+			for (int32 ColIdx = 0; ColIdx < ColumnCount; ++ColIdx)
+			{
+				const FBPDT_Column& Col = Columns[ColIdx];
+				const bool bIsNull = (Src[ColIdx / 8] & (1 << (ColIdx % 8))) != 0;
+
+				// Null cells still occupy their zero-filled slot in the file
+				if (bIsNull)
+				{
+					Cells.Add(FBPDT_Cell::MakeNull(Col.Type));
+				}
+				else
+				{
+					Cells.Emplace(Col.Type, Src + ColumnOffsets[ColIdx], Col.ByteSize);
+				}
+			}
+		}
+	});
+
+	return true;
+}
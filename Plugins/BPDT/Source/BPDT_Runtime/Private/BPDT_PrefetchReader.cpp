@@ -0,0 +1,148 @@
+#include "BPDT_PrefetchReader.h"
+
+#include "Async/AsyncFileHandle.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+
+static TAutoConsoleVariable<int32> CVarBPDTPrefetchDepth(
+	TEXT("BPDT.Prefetch.Depth"),
+	2,
+	TEXT("Reads of a table data file kept in flight ahead of the decoder (2 = double buffering)."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarBPDTPrefetchBlockKB(
+	TEXT("BPDT.Prefetch.BlockKB"),
+	1024,
+	TEXT("Size in KB of each read when a table data file is streamed in."),
+	ECVF_Default
+);
+
+FBPDT_PrefetchReader::FBPDT_PrefetchReader(const FString& Path)
+	: Handle(FPlatformFileManager::Get().GetPlatformFile().OpenAsyncRead(*Path))
+{
+}
+
+FBPDT_PrefetchReader::~FBPDT_PrefetchReader()
+{
+	// Requests must be gone before the handle
+	for (FPendingRead& Read : Pending)
+	{
+		if (!Read.Request)
+		{
+			continue;
+		}
+		Read.Request->WaitCompletion();
+		FMemory::Free(Read.Request->GetReadResults());
+		delete Read.Request;
+	}
+	Pending.Reset();
+	Handle.Reset();
+}
+
+int32 FBPDT_PrefetchReader::GetDepth()
+{
+	return FMath::Max(CVarBPDTPrefetchDepth.GetValueOnAnyThread(), 1);
+}
+
+int64 FBPDT_PrefetchReader::GetBlockBytes()
+{
+	return (int64)FMath::Max(CVarBPDTPrefetchBlockKB.GetValueOnAnyThread(), 4) * 1024;
+}
+
+void FBPDT_PrefetchReader::Prefetch(int64 Offset, int64 Bytes)
+{
+	check(Handle.IsValid() && Bytes > 0);
+
+	FPendingRead& Read = Pending.AddDefaulted_GetRef();
+	Read.Request = Handle->ReadRequest(Offset, Bytes, AIOP_Normal);
+	Read.Bytes = Bytes;
+}
+
+bool FBPDT_PrefetchReader::Next(uint8* Dest)
+{
+	if (Pending.Num() == 0)
+	{
+		return false;
+	}
+
+	const FPendingRead Read = Pending[0];
+	Pending.RemoveAt(0, EAllowShrinking::No);
+
+	if (!Read.Request)
+	{
+		return false;
+	}
+
+	Read.Request->WaitCompletion();
+	uint8* Memory = Read.Request->GetReadResults();
+	delete Read.Request;
+
+	if (!Memory)
+	{
+		return false;
+	}
+
+	FMemory::Memcpy(Dest, Memory, Read.Bytes);
+	FMemory::Free(Memory);
+	return true;
+}
+
+bool FBPDT_PrefetchReader::Read(int64 Offset, int64 Bytes, uint8* Dest)
+{
+	check(Pending.Num() == 0);
+
+	Prefetch(Offset, Bytes);
+	return Next(Dest);
+}
+
+bool FBPDT_PrefetchReader::Stream(
+	int64 Begin,
+	int64 End,
+	uint8* Dest,
+	TFunctionRef<bool(int64 ReadyEnd)> OnReady
+)
+{
+	check(Pending.Num() == 0);
+
+	const int64 BlockBytes = GetBlockBytes();
+	const int32 Depth = GetDepth();
+
+	int64 Issued = Begin;
+	int64 Ready = Begin;
+
+	auto IssueNext = [&]()
+	{
+		const int64 Bytes = FMath::Min(BlockBytes, End - Issued);
+		Prefetch(Issued, Bytes);
+		Issued += Bytes;
+	};
+
+	while (Issued < End && Pending.Num() < Depth)
+	{
+		IssueNext();
+	}
+
+	while (Ready < End)
+	{
+		const int64 Bytes = Pending[0].Bytes;
+		if (!Next(Dest + (Ready - Begin)))
+		{
+			return false;
+		}
+		Ready += Bytes;
+
+		// Keep the queue full while the caller works on this block
+		if (Issued < End)
+		{
+			IssueNext();
+		}
+
+		if (!OnReady(Ready))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
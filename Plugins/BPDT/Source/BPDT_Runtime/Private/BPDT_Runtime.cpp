@@ -1,6 +1,9 @@
 #include "BPDT_Runtime.h"
 #include "CoreMinimal.h"
 #include "BPDT_TableManager.h"
+#include "BPDT_CommandBuffer.h"
+#include "BPDT_WriteAheadLog.h"
+#include "BPDT_CookedTables.h"
 
 IMPLEMENT_MODULE(FBPDT_RuntimeModule, BPDT_Runtime)
 
@@ -8,15 +11,39 @@ void FBPDT_RuntimeModule::StartupModule()
 {
 	UE_LOG(LogTemp, Log, TEXT("[BPDT_Runtime] StartupModule"));
 
-	// Load all saved tables on editor / standalone / packaged startup
-	UBPDT_TableManager::LoadAllTables();
+	// Packaged builds: tables cooked into the content seed the catalog
+	FBPDT_CookedTables::Get().Mount();
+
+	// Load all saved tables on editor / standalone / packaged startup,
+	// or with BPDT.LazyLoad (or cooked tables) only register them
+	if (!UBPDT_TableManager::StartLazyLoading())
+	{
+		UBPDT_TableManager::LoadAllTables();
+	}
 	UBPDT_TableManager::LoadForeignKeys();
 	UBPDT_TableManager::ApplyForeignKeysToTables();
 
+	// Replays the log over the loaded tables, then logs from here on
+	FBPDT_WriteAheadLog::Get().Startup();
+
+	// Reports FK values that reference missing rows
+	UBPDT_TableManager::ValidateForeignKeysOnLoad();
+
+	FBPDT_CommandBuffer::Get().Startup();
+
 	UE_LOG(LogTemp, Log, TEXT("[BPDT_Runtime] All tables loaded"));
 }
 
 void FBPDT_RuntimeModule::ShutdownModule()
 {
 	UE_LOG(LogTemp, Log, TEXT("[BPDT_Runtime] ShutdownModule"));
+
+	FBPDT_CommandBuffer::Get().Shutdown();
+
+	// After the command buffer: its final flush is logged too
+	FBPDT_WriteAheadLog::Get().Shutdown();
+
+	UBPDT_TableManager::StopLazyLoading();
+
+	FBPDT_CookedTables::Get().Unmount();
 }
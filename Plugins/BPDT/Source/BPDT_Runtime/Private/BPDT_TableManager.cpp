@@ -1,10 +1,425 @@
 #include "BPDT_TableManager.h"
 #include "BPDT_FileManager.h"
+#include "BPDT_WriteAheadLog.h"
+#include "BPDT_BufferPool.h"
+#include "BPDT_TextIO.h"
+#include "BPDT_CookedTables.h"
+#include "Misc/ScopeRWLock.h"
+#include "Misc/ScopeLock.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ConfigCacheIni.h"
+#include "UObject/UObjectGlobals.h"
+#include "Engine/World.h"
+
+#include <atomic>
 
 
 static TMap<FString, FBPDT_Table> G_BPDT_Tables;
 TArray<FBPDT_ForeignKeyConstraint> UBPDT_TableManager::ForeignKeys;
 
+// Guards G_BPDT_Tables and ForeignKeys (see BPDT_TableAccess.h)
+static FRWLock G_BPDT_TablesLock;
+
+// Tables removed since the last full save, which drops their saved files so
+// the removal lasts. Guarded by the map lock.
+static TSet<FString> G_BPDT_RemovedTables;
+
+/* ---------------- Transactions ---------------- */
+
+/**
+ * Working set of an open transaction. Taken at Begin as copies of every table
+ * (O(columns) each, rows are shared copy-on-write), so writes only touch the
+ * transaction's copies and the live tables are the undo state: rollback just
+ * drops the copies, commit swaps the modified ones in.
+ */
+struct FBPDT_Transaction
+{
+	TMap<FString, FBPDT_Table> Tables;
+	TArray<FBPDT_ForeignKeyConstraint> ForeignKeys;
+
+	// State at Begin, for change and conflict detection on commit
+	TMap<FString, uint64> BaseVersions;
+	TArray<FBPDT_ForeignKeyConstraint> BaseForeignKeys;
+};
+
+static thread_local FBPDT_Transaction* G_BPDT_Transaction = nullptr;
+
+// Open transactions on all threads; idle unloading waits for zero
+static std::atomic<int32> G_BPDT_OpenTransactions{ 0 };
+
+// Tables visible to the calling thread
+static TMap<FString, FBPDT_Table>& VisibleTables()
+{
+	return G_BPDT_Transaction ? G_BPDT_Transaction->Tables : G_BPDT_Tables;
+}
+
+// Inside a transaction the commit notifies once for everything.
+// Callers hold no locks, the log takes its own.
+static void NotifyTablesChanged(const TArray<FString>& TableNames)
+{
+	if (G_BPDT_Transaction || TableNames.Num() == 0)
+	{
+		return;
+	}
+
+	FBPDT_WriteAheadLog::Get().LogTables(TableNames);
+
+	UBPDT_TableManager::OnTablesChanged().Broadcast(TableNames);
+}
+
+// DropColumn leaves the dropped cells in the rows; reclaim them off the
+// calling thread. Compacting changes no contents and no version, so it
+// notifies nothing and never conflicts with a transaction.
+static void CompactRowsAsync(TArray<FString> TableNames)
+{
+	if (TableNames.Num() == 0)
+	{
+		return;
+	}
+
+	Async(EAsyncExecution::ThreadPool, [TableNames = MoveTemp(TableNames)]()
+	{
+		for (const FString& Name : TableNames)
+		{
+			FReadScopeLock MapLock(G_BPDT_TablesLock);
+
+			FBPDT_Table* Table = G_BPDT_Tables.Find(Name);
+			if (Table)
+			{
+				FWriteScopeLock TableLock(Table->GetLock());
+				Table->CompactRows();
+			}
+		}
+	});
+}
+
+/* ---------------- Lazy loading ---------------- */
+
+static TAutoConsoleVariable<bool> CVarBPDTLazyLoad(
+	TEXT("BPDT.LazyLoad"),
+	false,
+	TEXT("Register saved tables at startup but load each one on first access. Read at startup."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarBPDTLazyUnloadSeconds(
+	TEXT("BPDT.LazyUnloadSeconds"),
+	0.0f,
+	TEXT("Lazy mode: unload tables without unsaved changes after this many idle seconds. 0 keeps them."),
+	ECVF_Default
+);
+
+static std::atomic<bool> G_BPDT_bLazy{ false };
+
+// Registered tables still on disk, and last access of the loaded ones.
+// Lock order: G_BPDT_LazyMutex -> G_BPDT_PagedLock -> map lock.
+static TSet<FString> G_BPDT_UnloadedTables;
+static TMap<FString, TSharedRef<std::atomic<double>>> G_BPDT_LastAccess;
+static FCriticalSection G_BPDT_LazyMutex;
+
+// Changes to G_BPDT_UnloadedTables and the keys of G_BPDT_LastAccess also
+// take this exclusive. Shared, it is enough to see whether a table is loaded
+// and to stamp its access; paged reads hold it so a table cannot get loaded
+// (and changed) under them.
+static FRWLock G_BPDT_PagedLock;
+
+// Loads in flight, so a second caller waits for that table only; and when a
+// failed table may be read again. Guarded by G_BPDT_LazyMutex, which is never
+// held across I/O.
+static TMap<FString, TSharedFuture<bool>> G_BPDT_LoadingTables;
+static TMap<FString, double> G_BPDT_LoadRetryTime;
+
+static constexpr double BPDT_LOAD_RETRY_SECONDS = 5.0;
+
+// Unloaded tables without a cooked PK order whose PK pages were scanned for
+// a row once. The next lookup loads the table instead, so a loop of lookups
+// costs one scan plus one load, not a scan each. Forgotten whenever a table
+// is installed, unloaded or removed, so a scan only ever covers the files
+// it saw. Leaf lock.
+static TSet<FString> G_BPDT_PKScannedTables;
+static FCriticalSection G_BPDT_PKScanMutex;
+
+static void ForgetPKScan(const FString& TableName)
+{
+	FScopeLock ScanLock(&G_BPDT_PKScanMutex);
+	G_BPDT_PKScannedTables.Remove(TableName);
+}
+
+static FTSTicker::FDelegateHandle G_BPDT_LazyTickHandle;
+static FDelegateHandle G_BPDT_LazyMapHandle;
+
+// FK metadata is not part of the table files: the marked table still
+// matches what is on disk
+static void MarkForeignKeyColumns(
+	const TArray<FBPDT_ForeignKeyConstraint>& ForeignKeys,
+	const FString& TableName,
+	FBPDT_Table& Table
+)
+{
+	const uint64 FilesVersion = Table.GetVersion();
+
+	for (const FBPDT_ForeignKeyConstraint& FK : ForeignKeys)
+	{
+		const int32 ColIndex = FK.FKTable == TableName ? Table.GetColumnIndex(FK.FKColumn) : INDEX_NONE;
+		if (ColIndex != INDEX_NONE)
+		{
+			Table.SetColumnForeignKey(ColIndex, FName(*FK.PKTable));
+		}
+	}
+
+	FBPDT_FileManager::NoteTableUnchanged(TableName, FilesVersion, Table.GetVersion());
+}
+
+/* ---------------- Paged reads ---------------- */
+
+struct FBPDT_PagedSchema
+{
+	TArray<FBPDT_Column> Columns;
+	FName PKColumnName;
+	int32 RowCount = 0;
+
+	int32 GroupCount() const
+	{
+		return (RowCount + BPDT_ROWS_PER_GROUP - 1) / BPDT_ROWS_PER_GROUP;
+	}
+
+	int32 FindColumn(FName Name) const
+	{
+		return Columns.IndexOfByPredicate(
+			[Name](const FBPDT_Column& Col) { return Col.Name == Name; });
+	}
+};
+
+/**
+ * Runs Read against buffer pool pages when TableName is still on disk, so
+ * the read does not load the table; cooked tables need no pool. Returns
+ * false when that does not apply (not lazy, pool off, table loaded) or Read
+ * gives up (e.g. an old file format); the caller then takes the loading path.
+ */
+static bool ReadPaged(const FString& TableName, TFunctionRef<bool(const FBPDT_PagedSchema&)> Read)
+{
+	if (!G_BPDT_bLazy ||
+		(!FBPDT_BufferPool::Get().IsEnabled() && !FBPDT_FileManager::IsTableCooked(TableName)))
+	{
+		return false;
+	}
+
+	FReadScopeLock PagedLock(G_BPDT_PagedLock);
+
+	if (!G_BPDT_UnloadedTables.Contains(TableName))
+	{
+		return false;
+	}
+
+	FBPDT_PagedSchema Schema;
+	return FBPDT_FileManager::ReadSavedSchema(TableName, Schema.Columns, Schema.PKColumnName, Schema.RowCount) &&
+		Read(Schema);
+}
+
+/* One whole column; NAME_None is the PK column, Type None accepts any type */
+static bool ReadColumnPaged(
+	const FString& TableName,
+	FName ColumnName,
+	EBPDT_CellType Type,
+	TArray<FBPDT_Cell>& OutCells
+)
+{
+	return ReadPaged(TableName, [&](const FBPDT_PagedSchema& Schema)
+	{
+		const int32 ColIndex = Schema.FindColumn(ColumnName.IsNone() ? Schema.PKColumnName : ColumnName);
+		if (ColIndex == INDEX_NONE ||
+			(Type != EBPDT_CellType::None && Schema.Columns[ColIndex].Type != Type))
+		{
+			return false;
+		}
+
+		OutCells.Reset(Schema.RowCount);
+		return FBPDT_FileManager::ReadColumnPages(TableName, ColIndex, 0, Schema.GroupCount(),
+			[&OutCells](int32, const FBPDT_PageRef& Page)
+			{
+				OutCells.Append(*Page);
+				return true;
+			}) &&
+			OutCells.Num() == Schema.RowCount;
+	});
+}
+
+/* One whole column as values; Convert maps a cell, null ones included, to a value */
+template<typename T, typename FConvert>
+static bool ReadColumnValuesPaged(
+	const FString& TableName,
+	FName ColumnName,
+	EBPDT_CellType Type,
+	TArray<T>& OutValues,
+	FConvert Convert
+)
+{
+	TArray<FBPDT_Cell> Paged;
+	if (!ReadColumnPaged(TableName, ColumnName, Type, Paged))
+	{
+		return false;
+	}
+
+	OutValues.Reserve(Paged.Num());
+	for (const FBPDT_Cell& Cell : Paged)
+	{
+		OutValues.Add(Convert(Cell));
+	}
+	return true;
+}
+
+/* One row by PK (as GetAllRowPKValues prints it); bOutFound is false for a missing key */
+static bool ReadRowPaged(
+	const FString& TableName,
+	const FString& PKValue,
+	TArray<FBPDT_Cell>& OutCells,
+	TArray<FBPDT_Column>& OutColumns,
+	bool& bOutFound
+)
+{
+	return ReadPaged(TableName, [&](const FBPDT_PagedSchema& Schema)
+	{
+		const int32 PKIndex = Schema.FindColumn(Schema.PKColumnName);
+		if (PKIndex == INDEX_NONE)
+		{
+			return false;
+		}
+
+		const FString Wanted = PKValue.TrimStartAndEnd();
+
+		int32 FoundGroup = INDEX_NONE;
+		int32 FoundRow = INDEX_NONE;
+
+		// ---- cooked tables carry a sorted PK order; others scan the PK pages, once ----
+		int32 CookedRow = INDEX_NONE;
+		const bool bCookedLookup = FBPDT_FileManager::FindCookedRow(TableName, Wanted, CookedRow);
+		if (CookedRow != INDEX_NONE)
+		{
+			FoundGroup = CookedRow / BPDT_ROWS_PER_GROUP;
+			FoundRow = CookedRow % BPDT_ROWS_PER_GROUP;
+		}
+
+		if (!bCookedLookup)
+		{
+			FScopeLock ScanLock(&G_BPDT_PKScanMutex);
+
+			bool bScannedBefore = false;
+			G_BPDT_PKScannedTables.Add(TableName, &bScannedBefore);
+			if (bScannedBefore)
+			{
+				return false;
+			}
+		}
+
+		for (int32 Group = 0; !bCookedLookup && Group < Schema.GroupCount() && FoundGroup == INDEX_NONE; ++Group)
+		{
+			FBPDT_PageRef Page;
+			if (!FBPDT_FileManager::ReadColumnPage(TableName, PKIndex, Group, Page))
+			{
+				return false;
+			}
+
+			FoundRow = Page->IndexOfByPredicate([&Wanted](const FBPDT_Cell& Cell)
+			{
+				return !Cell.bIsNull && FBPDT_PrimaryKey(Cell).ToString() == Wanted;
+			});
+
+			if (FoundRow != INDEX_NONE)
+			{
+				FoundGroup = Group;
+			}
+		}
+
+		bOutFound = FoundGroup != INDEX_NONE;
+		if (!bOutFound)
+		{
+			return true;
+		}
+
+		// ---- then that row group's page of every column ----
+		OutColumns = Schema.Columns;
+		OutCells.Reset(Schema.Columns.Num());
+
+		for (int32 ColIndex = 0; ColIndex < Schema.Columns.Num(); ++ColIndex)
+		{
+			FBPDT_PageRef Page;
+			if (!FBPDT_FileManager::ReadColumnPage(TableName, ColIndex, FoundGroup, Page))
+			{
+				return false;
+			}
+			OutCells.Add((*Page)[FoundRow]);
+		}
+		return true;
+	});
+}
+
+/* ---------------- Table scopes ---------------- */
+
+FBPDT_TableReadScope::FBPDT_TableReadScope(const FString& TableName)
+{
+	if (G_BPDT_bLazy)
+	{
+		UBPDT_TableManager::EnsureTablesLoaded({ TableName });
+	}
+
+	G_BPDT_TablesLock.ReadLock();
+
+	Table = VisibleTables().Find(TableName);
+	if (Table)
+	{
+		Table->GetLock().ReadLock();
+	}
+}
+
+FBPDT_TableReadScope::~FBPDT_TableReadScope()
+{
+	if (Table)
+	{
+		Table->GetLock().ReadUnlock();
+	}
+
+	G_BPDT_TablesLock.ReadUnlock();
+}
+
+FBPDT_TableWriteScope::FBPDT_TableWriteScope(const FString& InTableName)
+	: TableName(InTableName)
+{
+	if (G_BPDT_bLazy)
+	{
+		UBPDT_TableManager::EnsureTablesLoaded({ TableName });
+	}
+
+	G_BPDT_TablesLock.ReadLock();
+
+	Table = VisibleTables().Find(TableName);
+	if (Table)
+	{
+		Table->GetLock().WriteLock();
+		StartVersion = Table->GetVersion();
+	}
+}
+
+FBPDT_TableWriteScope::~FBPDT_TableWriteScope()
+{
+	bool bModified = false;
+
+	if (Table)
+	{
+		bModified = Table->GetVersion() != StartVersion;
+		Table->GetLock().WriteUnlock();
+	}
+
+	G_BPDT_TablesLock.ReadUnlock();
+
+	if (bModified)
+	{
+		NotifyTablesChanged({ TableName });
+	}
+}
+
 static bool ParseBool(const FString& Str, bool& OutValue)
 {
 	if (Str.Equals(TEXT("true"), ESearchCase::IgnoreCase) || Str == TEXT("1"))
@@ -54,7 +469,18 @@ bool UBPDT_TableManager::IsValidBPDTIdentifier(const FString& Name)
 
 TMap<FString, FBPDT_Table>& UBPDT_TableManager::GetTables()
 {
-	return G_BPDT_Tables;
+	return VisibleTables();
+}
+
+TArray<FBPDT_ForeignKeyConstraint>& UBPDT_TableManager::GetForeignKeys()
+{
+	return G_BPDT_Transaction ? G_BPDT_Transaction->ForeignKeys : ForeignKeys;
+}
+
+FBPDT_OnTablesChanged& UBPDT_TableManager::OnTablesChanged()
+{
+	static FBPDT_OnTablesChanged Delegate;
+	return Delegate;
 }
 
 bool UBPDT_TableManager::CreateTable(const FString& TableName)
@@ -70,22 +496,68 @@ bool UBPDT_TableManager::CreateTable(const FString& TableName)
 		return false;
 	}
 
-	if (GetTables().Contains(TableName))
-	{
-		return false;
-	}
-
 	FBPDT_Table Table;
 	Table.InitSerial();
 
-	GetTables().Add(TableName, MoveTemp(Table));
+	// A registered table that is still on disk exists too, even when it
+	// failed to load
+	EnsureTablesLoaded({ TableName });
+
+	{
+		FReadScopeLock PagedLock(G_BPDT_PagedLock);
+		FWriteScopeLock MapLock(G_BPDT_TablesLock);
+
+		if (GetTables().Contains(TableName) || G_BPDT_UnloadedTables.Contains(TableName))
+		{
+			return false;
+		}
+
+		GetTables().Add(TableName, MoveTemp(Table));
+		if (!G_BPDT_Transaction)
+		{
+			G_BPDT_RemovedTables.Remove(TableName);
+		}
+	}
+
+	NotifyTablesChanged({ TableName });
 	return true;
 }
 
 
 bool UBPDT_TableManager::RemoveTable(const FString& TableName)
 {
-	return GetTables().Remove(TableName) > 0;
+	EnsureTablesLoaded({ TableName });
+
+	{
+		FScopeLock LazyLock(&G_BPDT_LazyMutex);
+		FWriteScopeLock PagedLock(G_BPDT_PagedLock);
+		FWriteScopeLock MapLock(G_BPDT_TablesLock);
+
+		if (G_BPDT_Transaction)
+		{
+			// The commit removes it from the live tables
+			if (GetTables().Remove(TableName) == 0)
+			{
+				return false;
+			}
+		}
+		else
+		{
+			// A table that failed to load is still on disk and goes as well
+			const bool bLoaded = G_BPDT_Tables.Remove(TableName) > 0;
+			const bool bUnloaded = G_BPDT_UnloadedTables.Remove(TableName) > 0;
+			if (!bLoaded && !bUnloaded)
+			{
+				return false;
+			}
+
+			G_BPDT_RemovedTables.Add(TableName);
+			ForgetPKScan(TableName);
+		}
+	}
+
+	NotifyTablesChanged({ TableName });
+	return true;
 }
 
 bool UBPDT_TableManager::ConvertTableToExplicitPK(
@@ -95,13 +567,15 @@ bool UBPDT_TableManager::ConvertTableToExplicitPK(
 	const TArray<uint8>& DefaultData
 )
 {
-	FBPDT_Table* Table = GetTables().Find(TableName);
-	if (!Table || DefaultData.Num() == 0)
+	if (DefaultData.Num() == 0)
 	{
 		return false;
 	}
 
-	return Table->ConvertSerialToExplicit(
+	// The conversion validates before it mutates, so a failure leaves the
+	// table untouched without a transaction around it
+	FBPDT_TableWriteScope Table(TableName);
+	return Table && Table->ConvertSerialToExplicit(
 		NewPKColumnName,
 		Type,
 		DefaultData.GetData(),
@@ -111,16 +585,10 @@ bool UBPDT_TableManager::ConvertTableToExplicitPK(
 
 /* ---------------- Debug ---------------- */
 
-void UBPDT_TableManager::PrintTable(const FString& TableName)
+// Caller must hold the table's lock (shared is enough)
+static void PrintTableContents(const FString& TableName, const FBPDT_Table& Table)
 {
-	const FBPDT_Table* Table = GetTables().Find(TableName);
-	if (!Table)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("[BPDT] Table '%s' not found"), *TableName);
-		return;
-	}
-
-	const TArray<FBPDT_Column>& Columns = Table->GetColumns();
+	const TArray<FBPDT_Column>& Columns = Table.GetColumns();
 
 	UE_LOG(LogTemp, Warning, TEXT(""));
 	UE_LOG(LogTemp, Warning, TEXT("==== TABLE: %s ===="), *TableName);
@@ -140,13 +608,17 @@ void UBPDT_TableManager::PrintTable(const FString& TableName)
 	UE_LOG(LogTemp, Warning, TEXT("%s"), *Header);
 
 	// ---- Rows ----
-	Table->ForEachRow(
-		[&](const FBPDT_PrimaryKey&, const FBPDT_Row& Row)
+	// Formatting runs in parallel chunks; logging stays in row order
+	TArray<FString> Lines;
+	Lines.SetNum(Table.GetRowCount());
+
+	Table.ParallelForEachRow(
+		[&](int32 RowIndex, const FBPDT_PrimaryKey&, const FBPDT_Row& Row)
 		{
-			FString Line;
+			FString& Line = Lines[RowIndex];
 			for (int32 i = 0; i < Columns.Num(); ++i)
 			{
-				const FBPDT_Cell& Cell = Row.GetCell(i);
+				const FBPDT_Cell& Cell = Table.GetCell(Row, i);
 
 				FString ValueStr = TEXT("null");
 
@@ -189,23 +661,41 @@ void UBPDT_TableManager::PrintTable(const FString& TableName)
 
 				Line += FString::Printf(TEXT("[%s] "), *ValueStr);
 			}
-
-			UE_LOG(LogTemp, Warning, TEXT("%s"), *Line);
 		}
 	);
 
+	for (const FString& Line : Lines)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s"), *Line);
+	}
+
 	UE_LOG(LogTemp, Warning, TEXT("==== END TABLE ===="));
 	UE_LOG(LogTemp, Warning, TEXT(""));
 }
 
+void UBPDT_TableManager::PrintTable(const FString& TableName)
+{
+	const FBPDT_TableReadScope Table(TableName);
+	if (!Table)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[BPDT] Table '%s' not found"), *TableName);
+		return;
+	}
+
+	PrintTableContents(TableName, *Table);
+}
+
 void UBPDT_TableManager::PrintAllTables()
 {
 	UE_LOG(LogTemp, Warning, TEXT(""));
 	UE_LOG(LogTemp, Warning, TEXT("==== BPDT: ALL TABLES ===="));
 
+	FReadScopeLock MapLock(G_BPDT_TablesLock);
+
 	for (const auto& Pair : GetTables())
 	{
-		PrintTable(Pair.Key);
+		FReadScopeLock TableLock(Pair.Value.GetLock());
+		PrintTableContents(Pair.Key, Pair.Value);
 	}
 
 	UE_LOG(LogTemp, Warning, TEXT("==== END ALL TABLES ===="));
@@ -269,30 +759,119 @@ bool UBPDT_TableManager::AddVector3Column(
 	);
 }
 
-bool UBPDT_TableManager::AddDefaultRow(
+bool UBPDT_TableManager::DropColumn(
 	const FString& TableName,
-	int32& OutPrimaryKey
+	FName ColumnName
 )
 {
-	OutPrimaryKey = -1;
+	EnsureTablesLoaded({ TableName });
 
-	FBPDT_Table* Table = GetTables().Find(TableName);
-	if (!Table)
-	{
-		return false;
-	}
-
-	// This function ONLY applies to serial PK tables
-	if (Table->PKMode != EBPDT_PrimaryKeyMode::Serial)
 	{
-		return false;
-	}
+		// Exclusive: the FK list is checked against the drop
+		FWriteScopeLock MapLock(G_BPDT_TablesLock);
 
-	// Capture the PK that will be used
-	const int32 NewPKValue = Table->NextSerialID;
+		FBPDT_Table* Table = GetTables().Find(TableName);
+		if (!Table)
+		{
+			return false;
+		}
 
-	// Let the table handle row + PK creation
-	Table->InsertRowAsDefault();
+		for (const FBPDT_ForeignKeyConstraint& FK : GetForeignKeys())
+		{
+			if (FK.FKTable == TableName && FK.FKColumn == ColumnName)
+			{
+				UE_LOG(LogTemp, Warning,
+					TEXT("[BPDT] DropColumn failed. '%s.%s' is a foreign key."),
+					*TableName,
+					*ColumnName.ToString());
+				return false;
+			}
+		}
+
+		if (!Table->DropColumn(ColumnName))
+		{
+			return false;
+		}
+	}
+
+	NotifyTablesChanged({ TableName });
+
+	// A transaction's copy is compacted once the commit publishes it
+	if (!IsInTransaction())
+	{
+		CompactRowsAsync({ TableName });
+	}
+	return true;
+}
+
+bool UBPDT_TableManager::RenameColumn(
+	const FString& TableName,
+	FName OldColumnName,
+	FName NewColumnName
+)
+{
+	EnsureTablesLoaded({ TableName });
+
+	{
+		FWriteScopeLock MapLock(G_BPDT_TablesLock);
+
+		FBPDT_Table* Table = GetTables().Find(TableName);
+		if (!Table || !Table->RenameColumn(OldColumnName, NewColumnName))
+		{
+			return false;
+		}
+
+		// Constraints name their columns; follow the rename on either end
+		bool bForeignKeysChanged = false;
+		for (FBPDT_ForeignKeyConstraint& FK : GetForeignKeys())
+		{
+			if (FK.FKTable == TableName && FK.FKColumn == OldColumnName)
+			{
+				FK.FKColumn = NewColumnName;
+				bForeignKeysChanged = true;
+			}
+			if (FK.PKTable == TableName && FK.PKColumn == OldColumnName)
+			{
+				FK.PKColumn = NewColumnName;
+				bForeignKeysChanged = true;
+			}
+		}
+
+		// save immediately; a transaction saves on commit
+		if (bForeignKeysChanged && !IsInTransaction())
+		{
+			SaveForeignKeys_NoLock();
+		}
+	}
+
+	NotifyTablesChanged({ TableName });
+	return true;
+}
+
+bool UBPDT_TableManager::AddDefaultRow(
+	const FString& TableName,
+	int32& OutPrimaryKey
+)
+{
+	OutPrimaryKey = -1;
+
+	FBPDT_TableWriteScope Table(TableName);
+	if (!Table)
+	{
+		return false;
+	}
+
+	// This function ONLY applies to serial PK tables
+	if (Table->PKMode != EBPDT_PrimaryKeyMode::Serial)
+	{
+		return false;
+	}
+
+	// Capture the PK that will be used
+	const int32 NewPKValue = Table->NextSerialID;
+
+	// Let the table handle row + PK creation
+	Table->InsertRowAsDefault();
 
 	OutPrimaryKey = NewPKValue;
 	return true;
@@ -306,14 +885,14 @@ bool UBPDT_TableManager::SetCellInt(
 	int32 Value
 )
 {
-	FBPDT_Table* Table = GetTables().Find(TableName);
+	FBPDT_TableWriteScope Table(TableName);
 	if (!Table)
 	{
 		return false;
 	}
 
 	return SetCellTyped(
-		Table,
+		Table.Get(),
 		PKValue,
 		ColumnName,
 		EBPDT_CellType::Int,
@@ -328,14 +907,14 @@ bool UBPDT_TableManager::SetCellFloat(
 	float Value
 )
 {
-	FBPDT_Table* Table = GetTables().Find(TableName);
+	FBPDT_TableWriteScope Table(TableName);
 	if (!Table)
 	{
 		return false;
 	}
 
 	return SetCellTyped(
-		Table,
+		Table.Get(),
 		PKValue,
 		ColumnName,
 		EBPDT_CellType::Float,
@@ -350,14 +929,14 @@ bool UBPDT_TableManager::SetCellBool(
 	bool Value
 )
 {
-	FBPDT_Table* Table = GetTables().Find(TableName);
+	FBPDT_TableWriteScope Table(TableName);
 	if (!Table)
 	{
 		return false;
 	}
 
 	return SetCellTyped(
-		Table,
+		Table.Get(),
 		PKValue,
 		ColumnName,
 		EBPDT_CellType::Bool,
@@ -372,14 +951,14 @@ bool UBPDT_TableManager::SetCellVector3(
 	FVector Value
 )
 {
-	FBPDT_Table* Table = GetTables().Find(TableName);
+	FBPDT_TableWriteScope Table(TableName);
 	if (!Table)
 	{
 		return false;
 	}
 
 	return SetCellTyped(
-		Table,
+		Table.Get(),
 		PKValue,
 		ColumnName,
 		EBPDT_CellType::Vector3,
@@ -389,62 +968,43 @@ bool UBPDT_TableManager::SetCellVector3(
 
 bool UBPDT_TableManager::SaveTable(const FString& TableName)
 {
-	FBPDT_Table* Table = GetTables().Find(TableName);
+	// Serialize from a snapshot so writers are not blocked during file I/O
+	const TSharedRef<const FBPDT_DatabaseSnapshot> Snapshot = TakeSnapshot({ TableName });
+
+	const FBPDT_Table* Table = Snapshot->FindTable(TableName);
 	if (!Table)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("[BPDT] SaveTable failed. Table '%s' not found."), *TableName);
 		return false;
 	}
 
-	if (!FBPDT_FileManager::WriteTable(TableName, *Table))
-	{
-		UE_LOG(LogTemp, Warning, TEXT("[BPDT] SaveTable failed for table '%s'."), *TableName);
-		return false;
-	}
-
-	UE_LOG(LogTemp, Log, TEXT("[BPDT] Table '%s' saved successfully."), *TableName);
-	return true;
+	return WriteSnapshotTables(*Snapshot);
 }
 
 bool UBPDT_TableManager::SaveAllTables()
 {
-	TMap<FString, FBPDT_Table>& Tables = GetTables();
+	// One consistent snapshot for every table; no lock is held while writing
+	const TSharedRef<const FBPDT_DatabaseSnapshot> Snapshot = TakeSnapshot();
 
-	if (Tables.Num() == 0)
+	// Nothing loaded still saves: removals and FKs go to the catalog
+	if (Snapshot->Tables.Num() == 0)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[BPDT] SaveAllTables called but no tables exist."));
-		return false;
+		UE_LOG(LogTemp, Verbose, TEXT("[BPDT] SaveAllTables: no tables loaded, saving the catalog only."));
 	}
 
-	bool bAllSucceeded = true;
+	return WriteSnapshotTables(*Snapshot);
+}
 
-	for (const auto& Pair : Tables)
+bool UBPDT_TableManager::SetTableCompression(const FString& TableName, EBPDT_Compression Compression)
+{
+	FBPDT_TableWriteScope Table(TableName);
+	if (!Table)
 	{
-		const FString& TableName = Pair.Key;
-		const FBPDT_Table& Table = Pair.Value;
-
-		if (!FBPDT_FileManager::WriteTable(TableName, Table))
-		{
-			UE_LOG(
-				LogTemp,
-				Warning,
-				TEXT("[BPDT] Failed to save table '%s'."),
-				*TableName
-			);
-			bAllSucceeded = false;
-		}
-		else
-		{
-			UE_LOG(
-				LogTemp,
-				Log,
-				TEXT("[BPDT] Saved table '%s'."),
-				*TableName
-			);
-		}
+		return false;
 	}
 
-	return bAllSucceeded;
+	Table->SetCompression(Compression);
+	return true;
 }
 
 bool UBPDT_TableManager::LoadTable(const FString& TableName)
@@ -460,13 +1020,14 @@ bool UBPDT_TableManager::LoadTable(const FString& TableName)
 		return false;
 	}
 
-	FBPDT_Table Loaded;
-	if (!FBPDT_FileManager::ReadTable(TableName, Loaded))
+	// Decode outside the lock; only installing the result needs it
+	TMap<FString, FBPDT_Table> Loaded;
+	if (!ReadTables({ TableName }, Loaded))
 	{
 		return false;
 	}
 
-	GetTables().Add(TableName, MoveTemp(Loaded));
+	InstallTables(MoveTemp(Loaded));
 	return true;
 }
 
@@ -478,17 +1039,338 @@ bool UBPDT_TableManager::LoadAllTables()
 		return false;
 	}
 
-	bool bSuccess = true;
+	TMap<FString, FBPDT_Table> Loaded;
+	const bool bSuccess = ReadTables(Tables, Loaded);
+
+	InstallTables(MoveTemp(Loaded));
+	return bSuccess;
+}
+
+/* ---------------- Save / load helpers ---------------- */
+
+bool UBPDT_TableManager::WriteSnapshotTables(const FBPDT_DatabaseSnapshot& Snapshot)
+{
+	// Tables and FKs of the snapshot are published together, or not at all
+	if (!FBPDT_FileManager::WriteTables(Snapshot.Tables, &Snapshot.ForeignKeys, &Snapshot.RemovedTables))
+	{
+		UE_LOG(
+			LogTemp,
+			Warning,
+			TEXT("[BPDT] Failed to save %d tables; the previous save is kept."),
+			Snapshot.Tables.Num()
+		);
+		return false;
+	}
+
+	UE_LOG(
+		LogTemp,
+		Log,
+		TEXT("[BPDT] Saved %d tables."),
+		Snapshot.Tables.Num()
+	);
 
-	for (const FString& Name : Tables)
+	// Their files are gone now; a table created again since is not removed
+	if (Snapshot.RemovedTables.Num() > 0)
 	{
-		if (!LoadTable(Name))
+		FWriteScopeLock MapLock(G_BPDT_TablesLock);
+		for (const FString& TableName : Snapshot.RemovedTables)
 		{
-			bSuccess = false;
+			G_BPDT_RemovedTables.Remove(TableName);
 		}
 	}
+	return true;
+}
 
-	return bSuccess;
+bool UBPDT_TableManager::ReadTables(
+	const TArray<FString>& TableNames,
+	TMap<FString, FBPDT_Table>& OutTables
+)
+{
+	const int32 Count = TableNames.Num();
+	const double StartTime = FPlatformTime::Seconds();
+
+	TArray<FBPDT_Table> Loaded;
+	Loaded.SetNum(Count);
+
+	TArray<bool> Succeeded;
+	Succeeded.SetNumZeroed(Count);
+
+	TArray<double> Seconds;
+	Seconds.SetNumZeroed(Count);
+
+	// One task per table, so the file reads and decodes of all tables overlap;
+	// each decode fans out further over its own row groups
+	ParallelFor(Count, [&](int32 Index)
+	{
+		const double TableStart = FPlatformTime::Seconds();
+		Succeeded[Index] = FBPDT_FileManager::ReadTable(TableNames[Index], Loaded[Index]);
+		Seconds[Index] = FPlatformTime::Seconds() - TableStart;
+	}, EParallelForFlags::Unbalanced);
+
+	bool bAllSucceeded = true;
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const FString& Name = TableNames[Index];
+
+		if (!Succeeded[Index])
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[BPDT] Failed to load table '%s'."), *Name);
+			bAllSucceeded = false;
+			continue;
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("[BPDT] Loaded table '%s' (%d rows) in %.2f ms."),
+			*Name, Loaded[Index].GetRowCount(), Seconds[Index] * 1000.0);
+
+		OutTables.Add(Name, MoveTemp(Loaded[Index]));
+	}
+
+	if (Count > 1)
+	{
+		UE_LOG(LogTemp, Log, TEXT("[BPDT] Loaded %d of %d tables in %.2f ms."),
+			OutTables.Num(), Count, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+
+	return bAllSucceeded;
+}
+
+void UBPDT_TableManager::InstallTables(TMap<FString, FBPDT_Table>&& Tables)
+{
+	if (Tables.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<FString> Names;
+	Tables.GetKeys(Names);
+
+	{
+		FScopeLock LazyLock(&G_BPDT_LazyMutex);
+		FWriteScopeLock PagedLock(G_BPDT_PagedLock);
+
+		// Readers see either none or all of the loaded tables. Loads are not
+		// transactional: they always replace the live tables.
+		FWriteScopeLock MapLock(G_BPDT_TablesLock);
+
+		for (auto& Pair : Tables)
+		{
+			G_BPDT_UnloadedTables.Remove(Pair.Key);
+			G_BPDT_RemovedTables.Remove(Pair.Key);
+			ForgetPKScan(Pair.Key);
+			G_BPDT_Tables.Add(Pair.Key, MoveTemp(Pair.Value));
+		}
+	}
+
+	NotifyTablesChanged(Names);
+}
+
+/* ---------------- Async save / load ---------------- */
+
+TFuture<bool> UBPDT_TableManager::SaveTableAsync(const FString& TableName)
+{
+	// The snapshot is taken now, so the save reflects the call site
+	TSharedRef<const FBPDT_DatabaseSnapshot> Snapshot = TakeSnapshot({ TableName });
+
+	if (!Snapshot->FindTable(TableName))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[BPDT] SaveTableAsync failed. Table '%s' not found."), *TableName);
+		return MakeFulfilledPromise<bool>(false).GetFuture();
+	}
+
+	return Async(EAsyncExecution::ThreadPool, [Snapshot]()
+	{
+		return WriteSnapshotTables(*Snapshot);
+	});
+}
+
+TFuture<bool> UBPDT_TableManager::SaveAllTablesAsync()
+{
+	TSharedRef<const FBPDT_DatabaseSnapshot> Snapshot = TakeSnapshot();
+
+	// Nothing loaded still saves: removals and FKs go to the catalog, and a
+	// checkpoint needs the save to succeed to drop its log segments
+	if (Snapshot->Tables.Num() == 0)
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("[BPDT] SaveAllTablesAsync: no tables loaded, saving the catalog only."));
+	}
+
+	return Async(EAsyncExecution::ThreadPool, [Snapshot]()
+	{
+		return WriteSnapshotTables(*Snapshot);
+	});
+}
+
+TFuture<bool> UBPDT_TableManager::LoadTableAsync(const FString& TableName)
+{
+	return LoadTablesAsync(TableName);
+}
+
+TFuture<bool> UBPDT_TableManager::LoadAllTablesAsync()
+{
+	return LoadTablesAsync(FString());
+}
+
+TFuture<bool> UBPDT_TableManager::LoadTablesAsync(const FString& TableName)
+{
+	// Everything on the worker, install included: InstallTables takes its own
+	// locks, so the future never waits on the game thread and the game
+	// thread may block on it
+	return Async(EAsyncExecution::ThreadPool, [TableName]()
+	{
+		// ---- file I/O and decoding ----
+		TArray<FString> Names;
+		if (TableName.IsEmpty())
+		{
+			if (!FBPDT_FileManager::ReadRegistry(Names))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			if (!FBPDT_FileManager::IsTableInRegistry(TableName))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("[BPDT] Table '%s' not found in registry."), *TableName);
+				return false;
+			}
+			Names.Add(TableName);
+		}
+
+		TMap<FString, FBPDT_Table> Loaded;
+		const bool bAllRead = ReadTables(Names, Loaded);
+
+		// ---- install in one step ----
+		InstallTables(MoveTemp(Loaded));
+		return bAllRead;
+	});
+}
+
+/* ---------------- Bulk import / export ---------------- */
+
+static bool ImportTableText(
+	const FString& TableName,
+	const FString& FilePath,
+	EBPDT_TextFormat Format,
+	int32& OutImportedRows
+)
+{
+	OutImportedRows = 0;
+
+	// Parse against the current schema without holding the table
+	TArray<FBPDT_Column> Columns;
+	uint64 SchemaVersion = 0;
+	int32 SerialPKIndex = INDEX_NONE;
+	{
+		const FBPDT_TableReadScope Table(TableName);
+		if (!Table)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[BPDT] Import failed. Table '%s' not found."), *TableName);
+			return false;
+		}
+
+		Columns = Table->GetColumns();
+		SchemaVersion = Table->GetSchemaVersion();
+
+		if (Table->PKMode == EBPDT_PrimaryKeyMode::Serial)
+		{
+			SerialPKIndex = Table->GetColumnIndex(Table->GetPKColumnName());
+		}
+	}
+
+	TArray<FBPDT_Row> Rows;
+	if (!FBPDT_TextIO::ImportRows(FilePath, Format, Columns, SerialPKIndex, Rows))
+	{
+		return false;
+	}
+
+	FBPDT_TableWriteScope Table(TableName);
+	if (!Table)
+	{
+		return false;
+	}
+
+	if (Table->GetSchemaVersion() != SchemaVersion)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[BPDT] Import into '%s' failed. The schema changed while parsing."), *TableName);
+		return false;
+	}
+
+	if (SerialPKIndex != INDEX_NONE)
+	{
+		// Rows without an ID are numbered after every ID the file does give
+		int32 NextID = Table->NextSerialID;
+		for (const FBPDT_Row& Row : Rows)
+		{
+			const FBPDT_Cell& PKCell = Row.GetCell(SerialPKIndex);
+			if (!PKCell.bIsNull)
+			{
+				NextID = FMath::Max(NextID, PKCell.AsInt() + 1);
+			}
+		}
+
+		for (FBPDT_Row& Row : Rows)
+		{
+			if (Row.GetCell(SerialPKIndex).bIsNull)
+			{
+				const int32 ID = NextID++;
+				Row.SetCell(SerialPKIndex, FBPDT_Cell(EBPDT_CellType::Int, &ID, sizeof(int32)));
+			}
+		}
+	}
+
+	const int32 RowCount = Rows.Num();
+	if (!Table->AppendRows(MoveTemp(Rows)))
+	{
+		UE_LOG(LogTemp, Warning,
+			TEXT("[BPDT] Import into '%s' failed. A primary key is null or already taken."),
+			*TableName);
+		return false;
+	}
+
+	OutImportedRows = RowCount;
+
+	UE_LOG(LogTemp, Log, TEXT("[BPDT] Imported %d rows into '%s' from '%s'."), RowCount, *TableName, *FilePath);
+	return true;
+}
+
+static bool ExportTableText(
+	const FString& TableName,
+	const FString& FilePath,
+	EBPDT_TextFormat Format
+)
+{
+	// Formatting and writing run on the snapshot, with no lock held
+	TSharedRef<const FBPDT_DatabaseSnapshot> Snapshot = UBPDT_TableManager::TakeSnapshot({ TableName });
+
+	const FBPDT_Table* Table = Snapshot->FindTable(TableName);
+	if (!Table)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[BPDT] Export failed. Table '%s' not found."), *TableName);
+		return false;
+	}
+
+	return FBPDT_TextIO::ExportRows(FilePath, Format, *Table);
+}
+
+bool UBPDT_TableManager::ImportTableCSV(const FString& TableName, const FString& FilePath, int32& OutImportedRows)
+{
+	return ImportTableText(TableName, FilePath, EBPDT_TextFormat::CSV, OutImportedRows);
+}
+
+bool UBPDT_TableManager::ImportTableJSON(const FString& TableName, const FString& FilePath, int32& OutImportedRows)
+{
+	return ImportTableText(TableName, FilePath, EBPDT_TextFormat::JSON, OutImportedRows);
+}
+
+bool UBPDT_TableManager::ExportTableCSV(const FString& TableName, const FString& FilePath)
+{
+	return ExportTableText(TableName, FilePath, EBPDT_TextFormat::CSV);
+}
+
+bool UBPDT_TableManager::ExportTableJSON(const FString& TableName, const FString& FilePath)
+{
+	return ExportTableText(TableName, FilePath, EBPDT_TextFormat::JSON);
 }
 
 bool UBPDT_TableManager::AddStringColumn(
@@ -497,7 +1379,7 @@ bool UBPDT_TableManager::AddStringColumn(
 	const FString& DefaultValue
 )
 {
-	FBPDT_Table* Table = GetTables().Find(TableName);
+	FBPDT_TableWriteScope Table(TableName);
 	if (!Table)
 	{
 		return false;
@@ -533,14 +1415,14 @@ bool UBPDT_TableManager::SetCellString(
 	const FString& Value
 )
 {
-	FBPDT_Table* Table = GetTables().Find(TableName);
+	FBPDT_TableWriteScope Table(TableName);
 	if (!Table)
 	{
 		return false;
 	}
 
-	const FBPDT_Row* RowConst = Table->FindRow(PKValue);
-	if (!RowConst)
+	const int32 RowIndex = Table->FindRowIndex(PKValue);
+	if (RowIndex == INDEX_NONE)
 	{
 		return false;
 	}
@@ -578,8 +1460,7 @@ bool UBPDT_TableManager::SetCellString(
 		NewCell.bIsNull = false;
 	}
 
-	FBPDT_Row* Row = const_cast<FBPDT_Row*>(RowConst);
-	Row->SetCell(ColIndex, MoveTemp(NewCell));
+	Table->SetCellAt(RowIndex, ColIndex, NewCell);
 
 	return true;
 }
@@ -587,9 +1468,19 @@ bool UBPDT_TableManager::SetCellString(
 void UBPDT_TableManager::GetAllTableNames(TArray<FString>& OutTableNames)
 {
 	OutTableNames.Reset();
-	GetTables().GetKeys(OutTableNames);
-	OutTableNames.Sort();
-}
+
+	{
+		FReadScopeLock MapLock(G_BPDT_TablesLock);
+		GetTables().GetKeys(OutTableNames);
+	}
+
+	{
+		FReadScopeLock PagedLock(G_BPDT_PagedLock);
+		OutTableNames.Append(G_BPDT_UnloadedTables.Array());
+	}
+
+	OutTableNames.Sort();
+}
 
 bool UBPDT_TableManager::GetColumnInfo(
 	const FString& TableName,
@@ -600,7 +1491,7 @@ bool UBPDT_TableManager::GetColumnInfo(
 	OutColumnNames.Reset();
 	OutColumnTypes.Reset();
 
-	const FBPDT_Table* Table = GetTables().Find(TableName);
+	const FBPDT_TableReadScope Table(TableName);
 	if (!Table)
 	{
 		return false;
@@ -625,7 +1516,14 @@ bool UBPDT_TableManager::GetIntColumnData(
 {
 	OutValues.Reset();
 
-	const FBPDT_Table* Table = GetTables().Find(TableName);
+	// Lazy mode: a table still on disk is read through the buffer pool
+	if (ReadColumnValuesPaged(TableName, ColumnName, EBPDT_CellType::Int, OutValues,
+		[](const FBPDT_Cell& Cell) { return Cell.bIsNull ? 0 : Cell.AsInt(); }))
+	{
+		return true;
+	}
+
+	const FBPDT_TableReadScope Table(TableName);
 	if (!Table)
 		return false;
 
@@ -642,10 +1540,12 @@ bool UBPDT_TableManager::GetIntColumnData(
 			return false;
 	}
 
-	bool bAllValid = true;
+	std::atomic<bool> bAllValid{ true };
 
-	Table->ForEachRow(
-		[&](const FBPDT_PrimaryKey& PK, const FBPDT_Row& Row)
+	OutValues.SetNum(Table->GetRowCount());
+
+	Table->ParallelForEachRow(
+		[&](int32 RowIndex, const FBPDT_PrimaryKey& PK, const FBPDT_Row& Row)
 		{
 			int32 Value = 0;
 
@@ -656,15 +1556,15 @@ bool UBPDT_TableManager::GetIntColumnData(
 			}
 			else
 			{
-				const FBPDT_Cell& Cell = Row.GetCell(ColIndex);
+				const FBPDT_Cell& Cell = Table->GetCell(Row, ColIndex);
 				Value = Cell.bIsNull ? 0 : Cell.AsInt();
 			}
 
-			OutValues.Add(Value);
+			OutValues[RowIndex] = Value;
 		}
 	);
 
-	return bAllValid;
+	return bAllValid.load();
 }
 
 
@@ -676,7 +1576,14 @@ bool UBPDT_TableManager::GetFloatColumnData(
 {
 	OutValues.Reset();
 
-	const FBPDT_Table* Table = GetTables().Find(TableName);
+	// Lazy mode: a table still on disk is read through the buffer pool
+	if (ReadColumnValuesPaged(TableName, ColumnName, EBPDT_CellType::Float, OutValues,
+		[](const FBPDT_Cell& Cell) { return Cell.bIsNull ? 0.0f : Cell.AsFloat(); }))
+	{
+		return true;
+	}
+
+	const FBPDT_TableReadScope Table(TableName);
 	if (!Table)
 		return false;
 
@@ -693,10 +1600,12 @@ bool UBPDT_TableManager::GetFloatColumnData(
 			return false;
 	}
 
-	bool bAllValid = true;
+	std::atomic<bool> bAllValid{ true };
 
-	Table->ForEachRow(
-		[&](const FBPDT_PrimaryKey& PK, const FBPDT_Row& Row)
+	OutValues.SetNum(Table->GetRowCount());
+
+	Table->ParallelForEachRow(
+		[&](int32 RowIndex, const FBPDT_PrimaryKey& PK, const FBPDT_Row& Row)
 		{
 			float Value = 0.f;
 
@@ -707,15 +1616,15 @@ bool UBPDT_TableManager::GetFloatColumnData(
 			}
 			else
 			{
-				const FBPDT_Cell& Cell = Row.GetCell(ColIndex);
+				const FBPDT_Cell& Cell = Table->GetCell(Row, ColIndex);
 				Value = Cell.bIsNull ? 0.f : Cell.AsFloat();
 			}
 
-			OutValues.Add(Value);
+			OutValues[RowIndex] = Value;
 		}
 	);
 
-	return bAllValid;
+	return bAllValid.load();
 }
 
 
@@ -727,7 +1636,14 @@ bool UBPDT_TableManager::GetBoolColumnData(
 {
 	OutValues.Reset();
 
-	const FBPDT_Table* Table = GetTables().Find(TableName);
+	// Lazy mode: a table still on disk is read through the buffer pool
+	if (ReadColumnValuesPaged(TableName, ColumnName, EBPDT_CellType::Bool, OutValues,
+		[](const FBPDT_Cell& Cell) { return Cell.bIsNull ? false : Cell.AsBool(); }))
+	{
+		return true;
+	}
+
+	const FBPDT_TableReadScope Table(TableName);
 	if (!Table)
 		return false;
 
@@ -744,10 +1660,12 @@ bool UBPDT_TableManager::GetBoolColumnData(
 			return false;
 	}
 
-	bool bAllValid = true;
+	std::atomic<bool> bAllValid{ true };
 
-	Table->ForEachRow(
-		[&](const FBPDT_PrimaryKey& PK, const FBPDT_Row& Row)
+	OutValues.SetNum(Table->GetRowCount());
+
+	Table->ParallelForEachRow(
+		[&](int32 RowIndex, const FBPDT_PrimaryKey& PK, const FBPDT_Row& Row)
 		{
 			bool Value = false;
 
@@ -758,15 +1676,15 @@ bool UBPDT_TableManager::GetBoolColumnData(
 			}
 			else
 			{
-				const FBPDT_Cell& Cell = Row.GetCell(ColIndex);
+				const FBPDT_Cell& Cell = Table->GetCell(Row, ColIndex);
 				Value = Cell.bIsNull ? false : Cell.AsBool();
 			}
 
-			OutValues.Add(Value);
+			OutValues[RowIndex] = Value;
 		}
 	);
 
-	return bAllValid;
+	return bAllValid.load();
 }
 
 
@@ -778,7 +1696,14 @@ bool UBPDT_TableManager::GetStringColumnData(
 {
 	OutValues.Reset();
 
-	const FBPDT_Table* Table = GetTables().Find(TableName);
+	// Lazy mode: a table still on disk is read through the buffer pool
+	if (ReadColumnValuesPaged(TableName, ColumnName, EBPDT_CellType::String, OutValues,
+		[](const FBPDT_Cell& Cell) { return Cell.bIsNull ? FString() : Cell.AsString(); }))
+	{
+		return true;
+	}
+
+	const FBPDT_TableReadScope Table(TableName);
 	if (!Table)
 		return false;
 
@@ -795,17 +1720,19 @@ bool UBPDT_TableManager::GetStringColumnData(
 			return false;
 	}
 
-	Table->ForEachRow(
-		[&](const FBPDT_PrimaryKey& PK, const FBPDT_Row& Row)
+	OutValues.SetNum(Table->GetRowCount());
+
+	Table->ParallelForEachRow(
+		[&](int32 RowIndex, const FBPDT_PrimaryKey& PK, const FBPDT_Row& Row)
 		{
 			if (bIsPK)
 			{
-				OutValues.Add(PK.ToString());
+				OutValues[RowIndex] = PK.ToString();
 			}
 			else
 			{
-				const FBPDT_Cell& Cell = Row.GetCell(ColIndex);
-				OutValues.Add(Cell.bIsNull ? FString() : Cell.AsString());
+				const FBPDT_Cell& Cell = Table->GetCell(Row, ColIndex);
+				OutValues[RowIndex] = Cell.bIsNull ? FString() : Cell.AsString();
 			}
 		}
 	);
@@ -822,7 +1749,14 @@ bool UBPDT_TableManager::GetVector3ColumnData(
 {
 	OutValues.Reset();
 
-	const FBPDT_Table* Table = GetTables().Find(TableName);
+	// Lazy mode: a table still on disk is read through the buffer pool
+	if (ReadColumnValuesPaged(TableName, ColumnName, EBPDT_CellType::Vector3, OutValues,
+		[](const FBPDT_Cell& Cell) { return Cell.bIsNull ? FVector::ZeroVector : Cell.AsVector3(); }))
+	{
+		return true;
+	}
+
+	const FBPDT_TableReadScope Table(TableName);
 	if (!Table)
 	{
 		return false;
@@ -839,13 +1773,14 @@ bool UBPDT_TableManager::GetVector3ColumnData(
 		return false;
 	}
 
-	Table->ForEachRow(
-		[&](const FBPDT_PrimaryKey&, const FBPDT_Row& Row)
+	OutValues.SetNum(Table->GetRowCount());
+
+	Table->ParallelForEachRow(
+		[&](int32 RowIndex, const FBPDT_PrimaryKey&, const FBPDT_Row& Row)
 		{
-			const FBPDT_Cell& Cell = Row.GetCell(ColIndex);
-			OutValues.Add(
-				Cell.bIsNull ? FVector::ZeroVector : Cell.AsVector3()
-			);
+			const FBPDT_Cell& Cell = Table->GetCell(Row, ColIndex);
+			OutValues[RowIndex] =
+				Cell.bIsNull ? FVector::ZeroVector : Cell.AsVector3();
 		}
 	);
 
@@ -858,7 +1793,7 @@ bool UBPDT_TableManager::GetIntColumnDefault(
 	int32& OutDefaultValue
 )
 {
-	const FBPDT_Table* Table = GetTables().Find(TableName);
+	const FBPDT_TableReadScope Table(TableName);
 	if (!Table)
 	{
 		return false;
@@ -886,7 +1821,7 @@ bool UBPDT_TableManager::GetFloatColumnDefault(
 	float& OutDefaultValue
 )
 {
-	const FBPDT_Table* Table = GetTables().Find(TableName);
+	const FBPDT_TableReadScope Table(TableName);
 	if (!Table)
 	{
 		return false;
@@ -914,7 +1849,7 @@ bool UBPDT_TableManager::GetBoolColumnDefault(
 	bool& OutDefaultValue
 )
 {
-	const FBPDT_Table* Table = GetTables().Find(TableName);
+	const FBPDT_TableReadScope Table(TableName);
 	if (!Table)
 	{
 		return false;
@@ -942,7 +1877,7 @@ bool UBPDT_TableManager::GetVector3ColumnDefault(
 	FVector& OutDefaultValue
 )
 {
-	const FBPDT_Table* Table = GetTables().Find(TableName);
+	const FBPDT_TableReadScope Table(TableName);
 	if (!Table)
 	{
 		return false;
@@ -974,7 +1909,7 @@ bool UBPDT_TableManager::GetStringColumnDefaultAndMaxLength(
 	OutDefaultValue.Reset();
 	OutMaxLength = 0;
 
-	const FBPDT_Table* Table = GetTables().Find(TableName);
+	const FBPDT_TableReadScope Table(TableName);
 	if (!Table)
 	{
 		return false;
@@ -1012,18 +1947,19 @@ bool UBPDT_TableManager::GetStringColumnDefaultAndMaxLength(
 	}
 
 	// ---- Max length from row data ----
-	Table->ForEachRow(
-		[&](const FBPDT_PrimaryKey&, const FBPDT_Row& Row)
+	OutMaxLength = Table->ParallelReduce<int32>(
+		OutMaxLength,
+		[&Table, ColIndex](int32& Partial, const FBPDT_PrimaryKey&, const FBPDT_Row& Row)
 		{
-			const FBPDT_Cell& Cell = Row.GetCell(ColIndex);
+			const FBPDT_Cell& Cell = Table->GetCell(Row, ColIndex);
 			if (!Cell.bIsNull)
 			{
-				const FString Value = Cell.AsString();
-				OutMaxLength = FMath::Max(
-					OutMaxLength,
-					Value.Len()
-				);
+				Partial = FMath::Max(Partial, Cell.AsString().Len());
 			}
+		},
+		[](int32& Into, const int32& Partial)
+		{
+			Into = FMath::Max(Into, Partial);
 		}
 	);
 
@@ -1035,7 +1971,7 @@ bool UBPDT_TableManager::GetPKName(
 	FName& OutPKColumnName
 )
 {
-	const FBPDT_Table* Table = GetTables().Find(TableName);
+	const FBPDT_TableReadScope Table(TableName);
 	if (!Table)
 	{
 		return false;
@@ -1061,17 +1997,27 @@ bool UBPDT_TableManager::GetPKInfo(
 	bool& bIsSerial
 )
 {
-	const FBPDT_Table* Table = GetTables().Find(TableName);
+	const FBPDT_TableReadScope Table(TableName);
 	if (!Table)
 	{
 		return false;
 	}
 
-	bIsSerial = (Table->PKMode == EBPDT_PrimaryKeyMode::Serial);
+	return GetPKInfo_NoLock(*Table, OutPKColumnName, OutPKType, bIsSerial);
+}
+
+bool UBPDT_TableManager::GetPKInfo_NoLock(
+	const FBPDT_Table& Table,
+	FName& OutPKColumnName,
+	EBPDT_CellType& OutPKType,
+	bool& bIsSerial
+)
+{
+	bIsSerial = (Table.PKMode == EBPDT_PrimaryKeyMode::Serial);
 
 	if (bIsSerial)
 	{
-		const TArray<FBPDT_Column>& Columns = Table->GetColumns();
+		const TArray<FBPDT_Column>& Columns = Table.GetColumns();
 		if (Columns.Num() == 0)
 		{
 			return false;
@@ -1082,13 +2028,13 @@ bool UBPDT_TableManager::GetPKInfo(
 	}
 	else
 	{
-		const int32 PKIndex = Table->GetColumnIndex(Table->PKColumnName);
+		const int32 PKIndex = Table.GetColumnIndex(Table.PKColumnName);
 		if (PKIndex == INDEX_NONE)
 		{
 			return false;
 		}
 
-		const FBPDT_Column& Col = Table->GetColumn(PKIndex);
+		const FBPDT_Column& Col = Table.GetColumn(PKIndex);
 		OutPKColumnName = Col.Name;
 		OutPKType = Col.Type;
 	}
@@ -1102,7 +2048,26 @@ bool UBPDT_TableManager::GetTableRow(
 	FBPDT_RowView& OutRow
 )
 {
-	const FBPDT_Table* Table = GetTables().Find(TableName);
+	TArray<FBPDT_Cell> PagedCells;
+	TArray<FBPDT_Column> PagedColumns;
+	bool bFound = false;
+	if (ReadRowPaged(TableName, PKValue, PagedCells, PagedColumns, bFound))
+	{
+		if (!bFound)
+		{
+			return false;
+		}
+
+		OutRow.Cells = MoveTemp(PagedCells);
+		OutRow.ColumnIndexMap.Empty();
+		for (int32 i = 0; i < PagedColumns.Num(); ++i)
+		{
+			OutRow.ColumnIndexMap.Add(PagedColumns[i].Name, i);
+		}
+		return true;
+	}
+
+	const FBPDT_TableReadScope Table(TableName);
 	if (!Table)
 		return false;
 
@@ -1110,7 +2075,11 @@ bool UBPDT_TableManager::GetTableRow(
 	if (!Row)
 		return false;
 
-	OutRow.Cells = Row->Cells;
+	// Columns added since the row was written come back as their defaults
+	FBPDT_Row Copy;
+	Table->CopyRow(*Row, Copy);
+
+	OutRow.Cells = MoveTemp(Copy.Cells);
 	OutRow.ColumnIndexMap.Empty();
 
 	const TArray<FBPDT_Column>& Columns = Table->GetColumns();
@@ -1128,6 +2097,8 @@ void UBPDT_TableManager::GetAllTableSchemas(
 {
 	OutSchemas.Reset();
 
+	FReadScopeLock MapLock(G_BPDT_TablesLock);
+
 	const TMap<FString, FBPDT_Table>& Tables = GetTables();
 
 	for (const auto& Pair : Tables)
@@ -1135,6 +2106,8 @@ void UBPDT_TableManager::GetAllTableSchemas(
 		const FString& TableName = Pair.Key;
 		const FBPDT_Table& Table = Pair.Value;
 
+		FReadScopeLock TableLock(Table.GetLock());
+
 		FBPDT_TableSchemaView View;
 		View.TableName = TableName;
 
@@ -1159,7 +2132,18 @@ bool UBPDT_TableManager::GetAllRowPKValues(
 {
 	OutPKValues.Reset();
 
-	const FBPDT_Table* Table = GetTables().Find(TableName);
+	TArray<FBPDT_Cell> Paged;
+	if (ReadColumnPaged(TableName, NAME_None, EBPDT_CellType::None, Paged))
+	{
+		OutPKValues.Reserve(Paged.Num());
+		for (const FBPDT_Cell& Cell : Paged)
+		{
+			OutPKValues.Add(Cell.bIsNull ? FString() : FBPDT_PrimaryKey(Cell).ToString());
+		}
+		return true;
+	}
+
+	const FBPDT_TableReadScope Table(TableName);
 	if (!Table)
 	{
 		return false;
@@ -1181,49 +2165,81 @@ bool UBPDT_TableManager::ChangePrimaryKey(
 	const FString& NewPKValue
 )
 {
-	FBPDT_Table* Table = GetTables().Find(TableName);
-	if (!Table)
+	if (G_BPDT_bLazy)
 	{
-		return false;
+		// The cascade reaches every table referencing this one
+		TArray<FString> Involved = { TableName };
+		{
+			FReadScopeLock MapLock(G_BPDT_TablesLock);
+			for (const FBPDT_ForeignKeyConstraint& FK : GetForeignKeys())
+			{
+				if (FK.PKTable == TableName)
+				{
+					Involved.AddUnique(FK.FKTable);
+				}
+			}
+		}
+		EnsureTablesLoaded(Involved);
 	}
 
-	const bool bChanged =
-		Table->ChangePrimaryKey(OldPKValue, NewPKValue);
-
-	if (!bChanged)
+	TArray<FString> ChangedTables;
 	{
-		return false;
-	}
+		// The change and its cascade touch several tables: hold the map exclusive
+		// so no reader can observe the cascade half-applied.
+		FWriteScopeLock MapLock(G_BPDT_TablesLock);
 
-	// ---- CASCADE ----
-	CascadePrimaryKeyChange(
-		TableName,
-		OldPKValue,
-		NewPKValue
-	);
+		FBPDT_Table* Table = GetTables().Find(TableName);
+		if (!Table)
+		{
+			return false;
+		}
+
+		// Parsed up front: the cascade matches referencing cells by key
+		FBPDT_PrimaryKey OldKey;
+		FBPDT_PrimaryKey NewKey;
+		const bool bParsed =
+			Table->TryParsePKFromString(OldPKValue.TrimStartAndEnd(), OldKey) &&
+			Table->TryParsePKFromString(NewPKValue.TrimStartAndEnd(), NewKey);
+
+		const bool bChanged =
+			Table->ChangePrimaryKey(OldPKValue, NewPKValue);
+
+		if (!bChanged)
+		{
+			return false;
+		}
+
+		if (!bParsed || OldKey == NewKey)
+		{
+			return true;
+		}
+
+		ChangedTables.Add(TableName);
 
+		// ---- CASCADE ----
+		CascadePrimaryKeyChange(
+			TableName,
+			OldKey,
+			NewKey,
+			ChangedTables
+		);
+	}
+
+	NotifyTablesChanged(ChangedTables);
 	return true;
 }
 
 void UBPDT_TableManager::CascadePrimaryKeyChange(
 	const FString& ReferencedTableName,
-	const FString& OldPKValue,
-	const FString& NewPKValue
+	const FBPDT_PrimaryKey& OldKey,
+	const FBPDT_PrimaryKey& NewKey,
+	TArray<FString>& OutChangedTables
 )
 {
-	int32 OldID = 0;
-	int32 NewID = 0;
-
-	if (!LexTryParseString(OldID, *OldPKValue))
-		return;
-
-	if (!LexTryParseString(NewID, *NewPKValue))
-		return;
-
 	struct FCascadeOp
 	{
 		FBPDT_Table* Table;
-		FBPDT_PrimaryKey RowKey;
+		int32 RowIndex;
 		int32 ColumnIndex;
 	};
 
@@ -1231,6 +2247,7 @@ void UBPDT_TableManager::CascadePrimaryKeyChange(
 	const FName RefTableName(*ReferencedTableName);
 
 	// ---------- PHASE 1: COLLECT ----------
+	// Only the FK columns' reverse indexes are consulted; no rows are scanned
 	for (auto& TablePair : GetTables())
 	{
 		FBPDT_Table& FKTable = TablePair.Value;
@@ -1246,40 +2263,41 @@ void UBPDT_TableManager::CascadePrimaryKeyChange(
 			if (Col.ReferencedTableName != RefTableName)
 				continue;
 
-			// INT FK ONLY (for now)
-			if (Col.Type != EBPDT_CellType::Int)
+			if (Col.Type != NewKey.Type)
 				continue;
 
-			FKTable.ForEachRow(
-				[&](const FBPDT_PrimaryKey& RowPK, const FBPDT_Row& Row)
-				{
-					const FBPDT_Cell& Cell = Row.GetCell(ColIndex);
-					if (Cell.bIsNull)
-						return;
+			TArray<int32> Matches;
+			if (!FKTable.FindReferencingRows(ColIndex, OldKey, Matches))
+			{
+				// Every FK column is indexed when marked; scan if one is not
+				FKTable.ParallelFilter(
+					[&FKTable, ColIndex, &OldKey](const FBPDT_PrimaryKey&, const FBPDT_Row& Row)
+					{
+						const FBPDT_Cell& Cell = FKTable.GetCell(Row, ColIndex);
+						return !Cell.bIsNull && FBPDT_PrimaryKey(Cell) == OldKey;
+					},
+					Matches
+				);
+			}
 
-					int32 FKValue = 0;
-					FMemory::Memcpy(&FKValue, Cell.Data.GetData(), sizeof(int32));
+			for (const int32 RowIndex : Matches)
+			{
+				Ops.Add({ &FKTable, RowIndex, ColIndex });
+			}
 
-					if (FKValue == OldID)
-					{
-						Ops.Add({ &FKTable, RowPK, ColIndex });
-					}
-				}
-			);
+			if (Matches.Num() > 0)
+			{
+				OutChangedTables.AddUnique(TablePair.Key);
+			}
 		}
 	}
 
 	// ---------- PHASE 2: APPLY ----------
+	const FBPDT_Cell NewCell(NewKey.Type, NewKey.Data.GetData(), NewKey.Data.Num());
+
 	for (const FCascadeOp& Op : Ops)
 	{
-		FBPDT_Row* Row = Op.Table->FindRowMutable(Op.RowKey);
-		if (!Row)
-			continue;
-
-		Row->SetCell(
-			Op.ColumnIndex,
-			FBPDT_Cell(EBPDT_CellType::Int, &NewID, sizeof(int32))
-		);
+		Op.Table->SetCellAt(Op.RowIndex, Op.ColumnIndex, NewCell);
 	}
 }
 
@@ -1290,6 +2308,10 @@ bool UBPDT_TableManager::AddForeignKeyConstraint(
 	const FString& ReferencedTableName
 )
 {
+	EnsureTablesLoaded({ FKTableName, ReferencedTableName });
+
+	FWriteScopeLock MapLock(G_BPDT_TablesLock);
+
 	// ---- lookup tables ----
 	FBPDT_Table* FKTable = GetTables().Find(FKTableName);
 	if (!FKTable)
@@ -1310,8 +2332,7 @@ bool UBPDT_TableManager::AddForeignKeyConstraint(
 		return false;
 	}
 
-	FBPDT_Column& FKColumn =
-		const_cast<FBPDT_Column&>(FKTable->GetColumn(FKColIndex));
+	const FBPDT_Column& FKColumn = FKTable->GetColumn(FKColIndex);
 
 	// ---- cannot FK the PK column ----
 	if (FKColumnName == FKTable->GetPKColumnName())
@@ -1330,8 +2351,8 @@ bool UBPDT_TableManager::AddForeignKeyConstraint(
 	EBPDT_CellType RefPKType;
 	bool bIsSerial;
 
-	if (!GetPKInfo(
-		ReferencedTableName,
+	if (!GetPKInfo_NoLock(
+		*ReferencedTable,
 		RefPKName,
 		RefPKType,
 		bIsSerial
@@ -1347,19 +2368,21 @@ bool UBPDT_TableManager::AddForeignKeyConstraint(
 	}
 
 	// ---- declare FK constraint ----
-	FKColumn.bIsForeignKey = true;
-	FKColumn.ReferencedTableName = FName(*ReferencedTableName);
+	FKTable->SetColumnForeignKey(FKColIndex, FName(*ReferencedTableName));
 
 	// register FK for persistence
-	AddExistingForeignKeyConstraint(
+	AddExistingForeignKeyConstraint_NoLock(
 		FKTableName,
 		FKColumnName,
 		ReferencedTableName,
 		RefPKName
 	);
 
-	// save immediately
-	SaveForeignKeys();
+	// save immediately; a transaction saves on commit
+	if (!IsInTransaction())
+	{
+		SaveForeignKeys_NoLock();
+	}
 
 	return true;
 }
@@ -1371,9 +2394,12 @@ bool UBPDT_TableManager::IsValidFKConstraintOrdered(
 	FName FKColumnName
 )
 {
+	// Reads two tables at once: hold the map exclusive instead of two table locks
+	FWriteScopeLock MapLock(G_BPDT_TablesLock);
+
 	// ---- find tables ----
-	FBPDT_Table* PKTable = GetTables().Find(PKTableName);
-	FBPDT_Table* FKTable = GetTables().Find(FKTableName);
+	const FBPDT_Table* PKTable = GetTables().Find(PKTableName);
+	const FBPDT_Table* FKTable = GetTables().Find(FKTableName);
 
 	if (!PKTable || !FKTable)
 	{
@@ -1412,7 +2438,7 @@ bool UBPDT_TableManager::IsValidFKConstraintOrdered(
 	EBPDT_CellType OutPKType = EBPDT_CellType::None;
 	bool bIsSerial = false;
 
-	if (!UBPDT_TableManager::GetPKInfo(PKTableName, OutPKName, OutPKType, bIsSerial))
+	if (!GetPKInfo_NoLock(*PKTable, OutPKName, OutPKType, bIsSerial))
 	{
 		return false;
 	}
@@ -1438,6 +2464,20 @@ bool UBPDT_TableManager::AddExistingForeignKeyConstraint(
 	const FString& PKTable,
 	FName PKColumn
 )
+{
+	EnsureTablesLoaded({ FKTable, PKTable });
+
+	FWriteScopeLock MapLock(G_BPDT_TablesLock);
+
+	return AddExistingForeignKeyConstraint_NoLock(FKTable, FKColumn, PKTable, PKColumn);
+}
+
+bool UBPDT_TableManager::AddExistingForeignKeyConstraint_NoLock(
+	const FString& FKTable,
+	FName FKColumn,
+	const FString& PKTable,
+	FName PKColumn
+)
 {
 	// Basic validation
 	if (FKTable.IsEmpty() || PKTable.IsEmpty())
@@ -1451,7 +2491,7 @@ bool UBPDT_TableManager::AddExistingForeignKeyConstraint(
 	}
 
 	// Prevent duplicates
-	for (const FBPDT_ForeignKeyConstraint& FK : ForeignKeys)
+	for (const FBPDT_ForeignKeyConstraint& FK : GetForeignKeys())
 	{
 		if (FK.FKTable == FKTable &&
 			FK.FKColumn == FKColumn &&
@@ -1468,86 +2508,44 @@ bool UBPDT_TableManager::AddExistingForeignKeyConstraint(
 	NewFK.PKTable  = PKTable;
 	NewFK.PKColumn = PKColumn;
 
-	ForeignKeys.Add(NewFK);
+	GetForeignKeys().Add(NewFK);
 	return true;
 }
 
 bool UBPDT_TableManager::SaveForeignKeys()
 {
-	const FString Dir =
-		FPaths::ProjectSavedDir() / TEXT("Plugins/BPDT");
-
-	IFileManager::Get().MakeDirectory(*Dir, true);
-
-	const FString FilePath = Dir / TEXT("ForeignKeys.txt");
+	FReadScopeLock MapLock(G_BPDT_TablesLock);
 
-	FString Output;
-	for (const FBPDT_ForeignKeyConstraint& FK : ForeignKeys)
-	{
-		Output += FString::Printf(
-			TEXT("%s|%s|%s|%s\n"),
-			*FK.FKTable,
-			*FK.FKColumn.ToString(),
-			*FK.PKTable,
-			*FK.PKColumn.ToString()
-		);
-	}
+	return SaveForeignKeys_NoLock();
+}
 
-	return FFileHelper::SaveStringToFile(Output, *FilePath);
+bool UBPDT_TableManager::SaveForeignKeys_NoLock()
+{
+	return FBPDT_FileManager::WriteForeignKeys(ForeignKeys);
 }
 
 
 bool UBPDT_TableManager::LoadForeignKeys()
 {
-	const FString FilePath =
-		FPaths::ProjectSavedDir() / TEXT("Plugins/BPDT/ForeignKeys.txt");
-
-	if (!FPaths::FileExists(FilePath))
-	{
-		return true; // No constraints is valid
-	}
-
-	FString Input;
-	if (!FFileHelper::LoadFileToString(Input, *FilePath))
+	// Empty when none were saved; no constraints is valid
+	TArray<FBPDT_ForeignKeyConstraint> Loaded;
+	if (!FBPDT_FileManager::ReadForeignKeys(Loaded))
 	{
 		return false;
 	}
 
-	ForeignKeys.Empty();
-
-	TArray<FString> Lines;
-	Input.ParseIntoArrayLines(Lines);
-
-	for (const FString& Line : Lines)
-	{
-		if (Line.IsEmpty())
-		{
-			continue;
-		}
-
-		TArray<FString> Parts;
-		Line.ParseIntoArray(Parts, TEXT("|"), true);
-
-		if (Parts.Num() != 4)
-		{
-			continue; // malformed line
-		}
-
-		FBPDT_ForeignKeyConstraint FK;
-		FK.FKTable  = Parts[0];
-		FK.FKColumn = FName(*Parts[1]);
-		FK.PKTable  = Parts[2];
-		FK.PKColumn = FName(*Parts[3]);
-
-		ForeignKeys.Add(FK);
-	}
+	FWriteScopeLock MapLock(G_BPDT_TablesLock);
 
+	ForeignKeys = MoveTemp(Loaded);
 	return true;
 }
 
 void UBPDT_TableManager::ApplyForeignKeysToTables()
 {
-	for (const FBPDT_ForeignKeyConstraint& FK : ForeignKeys)
+	FScopeLock LazyLock(&G_BPDT_LazyMutex);
+	FWriteScopeLock MapLock(G_BPDT_TablesLock);
+
+	for (const FBPDT_ForeignKeyConstraint& FK : GetForeignKeys())
 	{
 		FBPDT_Table* FKTable = GetTables().Find(FK.FKTable);
 		if (!FKTable)
@@ -1568,8 +2566,11 @@ void UBPDT_TableManager::ApplyForeignKeysToTables()
 			continue;
 		}
 
-		FBPDT_Table* PKTable = GetTables().Find(FK.PKTable);
-		if (!PKTable)
+		// In lazy mode the referenced table may still be on disk
+		const bool bPKTableKnown =
+			GetTables().Contains(FK.PKTable) ||
+			G_BPDT_UnloadedTables.Contains(FK.PKTable);
+		if (!bPKTableKnown)
 		{
 			UE_LOG(LogTemp, Warning,
 				TEXT("[BPDT][FK] PKTable '%s' not found"),
@@ -1577,11 +2578,9 @@ void UBPDT_TableManager::ApplyForeignKeysToTables()
 			continue;
 		}
 
-		FBPDT_Column& Col =
-			const_cast<FBPDT_Column&>(FKTable->GetColumn(ColIndex));
-
-		Col.bIsForeignKey = true;
-		Col.ReferencedTableName = FName(*FK.PKTable);
+		const uint64 FilesVersion = FKTable->GetVersion();
+		FKTable->SetColumnForeignKey(ColIndex, FName(*FK.PKTable));
+		FBPDT_FileManager::NoteTableUnchanged(FK.FKTable, FilesVersion, FKTable->GetVersion());
 
 		UE_LOG(LogTemp, Log,
 			TEXT("[BPDT][FK] Applied FK %s.%s -> %s"),
@@ -1591,3 +2590,772 @@ void UBPDT_TableManager::ApplyForeignKeysToTables()
 	}
 }
 
+/* ---------------- FK validation ---------------- */
+
+static TAutoConsoleVariable<bool> CVarBPDTValidateForeignKeysOnLoad(
+	TEXT("BPDT.FKValidation.OnLoad"),
+	true,
+	TEXT("Check every FK value against its referenced table once the tables are loaded at startup."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<bool> CVarBPDTForeignKeyBloom(
+	TEXT("BPDT.FKValidation.Bloom"),
+	false,
+	TEXT("Screen FK values with a Bloom filter of the referenced PKs before probing the PK index. Pays off when many values are orphaned."),
+	ECVF_Default
+);
+
+// Orphans listed per constraint in its report
+static constexpr int32 BPDT_FK_ORPHAN_SAMPLES = 8;
+
+/**
+ * Bloom filter over the PKs of one table: 16 bits per key and 4 probes
+ * (about 0.2% false positives). A miss proves the key absent without
+ * touching the PK index.
+ */
+struct FBPDT_KeyBloomFilter
+{
+	static constexpr int32 NumProbes = 4;
+
+	TArray<uint64> Words;
+	uint64 Mask = 0;
+
+	explicit FBPDT_KeyBloomFilter(const FBPDT_Table& Table)
+	{
+		const uint64 NumBits = FMath::RoundUpToPowerOfTwo64(
+			FMath::Max<uint64>(64, (uint64)Table.GetRowCount() * 16));
+
+		Words.SetNumZeroed((int32)(NumBits / 64));
+		Mask = NumBits - 1;
+
+		for (int32 RowIndex = 0; RowIndex < Table.GetRowCount(); ++RowIndex)
+		{
+			uint64 H1, H2;
+			Split(Table.GetKeyAt(RowIndex), H1, H2);
+			for (int32 i = 0; i < NumProbes; ++i)
+			{
+				const uint64 Bit = (H1 + i * H2) & Mask;
+				Words[(int32)(Bit >> 6)] |= 1ull << (Bit & 63);
+			}
+		}
+	}
+
+	bool MayContain(const FBPDT_PrimaryKey& Key) const
+	{
+		uint64 H1, H2;
+		Split(Key, H1, H2);
+		for (int32 i = 0; i < NumProbes; ++i)
+		{
+			const uint64 Bit = (H1 + i * H2) & Mask;
+			if (!(Words[(int32)(Bit >> 6)] & (1ull << (Bit & 63))))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Double hashing: probe i is H1 + i * H2
+	static void Split(const FBPDT_PrimaryKey& Key, uint64& OutH1, uint64& OutH2)
+	{
+		const uint64 Mixed = (uint64)GetTypeHash(Key) * 0x9E3779B97F4A7C15ull;
+		OutH1 = Mixed;
+		OutH2 = (Mixed >> 32) | 1;
+	}
+};
+
+bool UBPDT_TableManager::ValidateForeignKeys(TArray<FBPDT_ForeignKeyReport>& OutReports)
+{
+	OutReports.Reset();
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Reads spanning two tables: hold the map exclusive (BPDT_TableAccess.h)
+	FWriteScopeLock MapLock(G_BPDT_TablesLock);
+
+	struct FCheck
+	{
+		const FBPDT_Table* FKTable;
+		int32 ColumnIndex;
+		const FBPDT_Table* PKTable;
+		int32 FilterIndex;
+	};
+
+	TArray<FCheck> Checks;
+	TArray<const FBPDT_Table*> Referenced;
+
+	// Resolved on this thread: inside a transaction GetTables() is per thread.
+	// Tables not loaded (lazy mode) or missing are skipped; the latter are
+	// reported by ApplyForeignKeysToTables.
+	for (const FBPDT_ForeignKeyConstraint& FK : GetForeignKeys())
+	{
+		const FBPDT_Table* FKTable = GetTables().Find(FK.FKTable);
+		const FBPDT_Table* PKTable = GetTables().Find(FK.PKTable);
+		const int32 ColIndex = FKTable ? FKTable->GetColumnIndex(FK.FKColumn) : INDEX_NONE;
+
+		if (!PKTable || ColIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		FBPDT_ForeignKeyReport& Report = OutReports.AddDefaulted_GetRef();
+		Report.FKTable = FK.FKTable;
+		Report.FKColumn = FK.FKColumn;
+		Report.PKTable = FK.PKTable;
+
+		Checks.Add({ FKTable, ColIndex, PKTable, Referenced.AddUnique(PKTable) });
+	}
+
+	// ---- one filter per referenced table, built once and in parallel ----
+	TArray<TUniquePtr<FBPDT_KeyBloomFilter>> Filters;
+	Filters.SetNum(Referenced.Num());
+
+	if (CVarBPDTForeignKeyBloom.GetValueOnAnyThread())
+	{
+		ParallelFor(Referenced.Num(),
+			[&](int32 Index)
+			{
+				Filters[Index] = MakeUnique<FBPDT_KeyBloomFilter>(*Referenced[Index]);
+			});
+	}
+
+	// ---- FK columns in parallel; the referenced PK index is the hash set ----
+	ParallelFor(Checks.Num(),
+		[&](int32 CheckIndex)
+		{
+			const FCheck& Check = Checks[CheckIndex];
+			const FBPDT_KeyBloomFilter* Filter = Filters[Check.FilterIndex].Get();
+			FBPDT_ForeignKeyReport& Report = OutReports[CheckIndex];
+
+			auto IsOrphan = [&](const FBPDT_PrimaryKey& Key)
+			{
+				return (Filter && !Filter->MayContain(Key)) || !Check.PKTable->ContainsKey(Key);
+			};
+
+			auto AddSample = [&](int32 RowIndex, const FBPDT_PrimaryKey& Key)
+			{
+				if (Report.OrphanSamples.Num() < BPDT_FK_ORPHAN_SAMPLES)
+				{
+					Report.OrphanSamples.Add(FString::Printf(TEXT("%s -> %s"),
+						*Check.FKTable->GetKeyAt(RowIndex).ToString(),
+						*Key.ToString()));
+				}
+			};
+
+			// One lookup per distinct value through the column's reverse index
+			const bool bIndexed = Check.FKTable->ForEachReference(Check.ColumnIndex,
+				[&](const FBPDT_PrimaryKey& Key, const TArray<int32>& RowIndices)
+				{
+					if (!IsOrphan(Key))
+					{
+						return;
+					}
+
+					Report.OrphanCount += RowIndices.Num();
+					for (int32 i = 0; i < RowIndices.Num() && Report.OrphanSamples.Num() < BPDT_FK_ORPHAN_SAMPLES; ++i)
+					{
+						AddSample(RowIndices[i], Key);
+					}
+				});
+
+			if (bIndexed)
+			{
+				return;
+			}
+
+			// Not marked as an FK column yet: one lookup per row
+			for (int32 RowIndex = 0; RowIndex < Check.FKTable->GetRowCount(); ++RowIndex)
+			{
+				const FBPDT_Cell& Cell = Check.FKTable->GetCellAt(RowIndex, Check.ColumnIndex);
+				if (Cell.bIsNull)
+				{
+					continue;
+				}
+
+				const FBPDT_PrimaryKey Key(Cell);
+				if (IsOrphan(Key))
+				{
+					++Report.OrphanCount;
+					AddSample(RowIndex, Key);
+				}
+			}
+		});
+
+	int32 TotalOrphans = 0;
+	for (const FBPDT_ForeignKeyReport& Report : OutReports)
+	{
+		if (Report.OrphanCount == 0)
+		{
+			continue;
+		}
+
+		TotalOrphans += Report.OrphanCount;
+		UE_LOG(LogTemp, Warning,
+			TEXT("[BPDT][FK] %s.%s -> %s: %d orphaned rows (%s)"),
+			*Report.FKTable,
+			*Report.FKColumn.ToString(),
+			*Report.PKTable,
+			Report.OrphanCount,
+			*FString::Join(Report.OrphanSamples, TEXT(", ")));
+	}
+
+	UE_LOG(LogTemp, Log,
+		TEXT("[BPDT][FK] Validated %d foreign keys in %.2f ms, %d orphaned rows."),
+		OutReports.Num(),
+		(FPlatformTime::Seconds() - StartTime) * 1000.0,
+		TotalOrphans);
+
+	return TotalOrphans == 0;
+}
+
+void UBPDT_TableManager::ValidateForeignKeysOnLoad()
+{
+	if (!CVarBPDTValidateForeignKeysOnLoad.GetValueOnAnyThread())
+	{
+		return;
+	}
+
+	TArray<FBPDT_ForeignKeyReport> Reports;
+	ValidateForeignKeys(Reports);
+}
+
+/* ---------------- Deferred commands ---------------- */
+
+int32 UBPDT_TableManager::FlushCommandBuffer()
+{
+	return FBPDT_CommandBuffer::Get().Flush();
+}
+
+void UBPDT_TableManager::SetCommandBufferFlushPoint(EBPDT_CommandFlushPoint FlushPoint)
+{
+	FBPDT_CommandBuffer::Get().SetFlushPoint(FlushPoint);
+}
+
+/* ---------------- Transactions ---------------- */
+
+bool UBPDT_TableManager::BeginTransaction()
+{
+	if (G_BPDT_Transaction)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[BPDT] BeginTransaction failed. A transaction is already open on this thread."));
+		return false;
+	}
+
+	FBPDT_Transaction* Transaction = new FBPDT_Transaction();
+	{
+		// Exclusive: no table scope is open, so the copies are one point in time
+		FWriteScopeLock MapLock(G_BPDT_TablesLock);
+
+		Transaction->Tables = G_BPDT_Tables;
+		Transaction->ForeignKeys = ForeignKeys;
+	}
+
+	Transaction->BaseForeignKeys = Transaction->ForeignKeys;
+	Transaction->BaseVersions.Reserve(Transaction->Tables.Num());
+	for (const auto& Pair : Transaction->Tables)
+	{
+		Transaction->BaseVersions.Add(Pair.Key, Pair.Value.GetVersion());
+	}
+
+	G_BPDT_Transaction = Transaction;
+	++G_BPDT_OpenTransactions;
+	return true;
+}
+
+bool UBPDT_TableManager::CommitTransaction()
+{
+	TUniquePtr<FBPDT_Transaction> Transaction(G_BPDT_Transaction);
+	if (!Transaction)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[BPDT] CommitTransaction called without an open transaction."));
+		return false;
+	}
+
+	// From here on this thread sees the live tables again
+	G_BPDT_Transaction = nullptr;
+	--G_BPDT_OpenTransactions;
+
+	TArray<FString> Written;
+	TArray<FString> Removed;
+
+	for (const auto& Pair : Transaction->Tables)
+	{
+		const uint64* BaseVersion = Transaction->BaseVersions.Find(Pair.Key);
+		if (!BaseVersion || *BaseVersion != Pair.Value.GetVersion())
+		{
+			Written.Add(Pair.Key);
+		}
+	}
+
+	for (const auto& Pair : Transaction->BaseVersions)
+	{
+		if (!Transaction->Tables.Contains(Pair.Key))
+		{
+			Removed.Add(Pair.Key);
+		}
+	}
+
+	const bool bForeignKeysChanged =
+		Transaction->ForeignKeys != Transaction->BaseForeignKeys;
+
+	TArray<FString> Changed = Written;
+	Changed.Append(Removed);
+
+	TArray<FString> Compact;
+
+	{
+		FWriteScopeLock MapLock(G_BPDT_TablesLock);
+
+		// ---- optimistic check: nothing we wrote changed underneath us ----
+		for (const FString& Name : Changed)
+		{
+			const uint64* BaseVersion = Transaction->BaseVersions.Find(Name);
+			const FBPDT_Table* Live = G_BPDT_Tables.Find(Name);
+
+			const bool bUnchanged = BaseVersion
+				? (Live && Live->GetVersion() == *BaseVersion)
+				: (Live == nullptr);
+
+			if (!bUnchanged)
+			{
+				UE_LOG(LogTemp, Warning,
+					TEXT("[BPDT] Transaction rolled back. Table '%s' was modified concurrently."),
+					*Name);
+				return false;
+			}
+		}
+
+		if (bForeignKeysChanged && ForeignKeys != Transaction->BaseForeignKeys)
+		{
+			UE_LOG(LogTemp, Warning,
+				TEXT("[BPDT] Transaction rolled back. Foreign keys were modified concurrently."));
+			return false;
+		}
+
+		// ---- publish everything at once ----
+		for (const FString& Name : Written)
+		{
+			FBPDT_Table& Table = Transaction->Tables[Name];
+			if (Table.HasDroppedCells())
+			{
+				Compact.Add(Name);
+			}
+			G_BPDT_Tables.Add(Name, MoveTemp(Table));
+		}
+
+		for (const FString& Name : Removed)
+		{
+			G_BPDT_Tables.Remove(Name);
+			G_BPDT_RemovedTables.Add(Name);
+		}
+
+		if (bForeignKeysChanged)
+		{
+			ForeignKeys = MoveTemp(Transaction->ForeignKeys);
+			SaveForeignKeys_NoLock();
+		}
+	}
+
+	NotifyTablesChanged(Changed);
+	CompactRowsAsync(MoveTemp(Compact));
+	return true;
+}
+
+bool UBPDT_TableManager::RollbackTransaction()
+{
+	if (!G_BPDT_Transaction)
+	{
+		return false;
+	}
+
+	// The live tables were never touched; dropping the copies is the undo
+	delete G_BPDT_Transaction;
+	G_BPDT_Transaction = nullptr;
+	--G_BPDT_OpenTransactions;
+	return true;
+}
+
+bool UBPDT_TableManager::IsInTransaction()
+{
+	return G_BPDT_Transaction != nullptr;
+}
+
+/* ---------------- Lazy loading ---------------- */
+
+bool UBPDT_TableManager::StartLazyLoading()
+{
+	// Cooked tables are served from their mapping, never loaded up front
+	if (!CVarBPDTLazyLoad.GetValueOnAnyThread() && !FBPDT_CookedTables::Get().IsMounted())
+	{
+		return false;
+	}
+
+	TArray<FString> Names;
+	FBPDT_FileManager::ReadRegistry(Names);
+
+	{
+		FScopeLock LazyLock(&G_BPDT_LazyMutex);
+		FWriteScopeLock PagedLock(G_BPDT_PagedLock);
+		FReadScopeLock MapLock(G_BPDT_TablesLock);
+
+		for (const FString& Name : Names)
+		{
+			if (!G_BPDT_Tables.Contains(Name))
+			{
+				G_BPDT_UnloadedTables.Add(Name);
+			}
+		}
+	}
+
+	G_BPDT_bLazy = true;
+
+	// ---- per-map preload hints: [BPDT.Preload] MapName=TableA,TableB in Game.ini ----
+	G_BPDT_LazyMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddLambda([](UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+
+		FString Hint;
+		if (!GConfig->GetString(TEXT("BPDT.Preload"), *World->GetMapName(), Hint, GGameIni))
+		{
+			return;
+		}
+
+		TArray<FString> TableNames;
+		Hint.ParseIntoArray(TableNames, TEXT(","), true);
+		for (FString& Name : TableNames)
+		{
+			Name.TrimStartAndEndInline();
+		}
+
+		Async(EAsyncExecution::ThreadPool, [TableNames]()
+		{
+			EnsureTablesLoaded(TableNames);
+		});
+	});
+
+	G_BPDT_LazyTickHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateStatic(&UBPDT_TableManager::UnloadIdleTables),
+		1.0f
+	);
+
+	UE_LOG(LogTemp, Log, TEXT("[BPDT] Lazy loading: %d tables registered."), Names.Num());
+	return true;
+}
+
+void UBPDT_TableManager::StopLazyLoading()
+{
+	if (!G_BPDT_bLazy)
+	{
+		return;
+	}
+
+	FTSTicker::GetCoreTicker().RemoveTicker(G_BPDT_LazyTickHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(G_BPDT_LazyMapHandle);
+
+	G_BPDT_LazyTickHandle.Reset();
+	G_BPDT_LazyMapHandle.Reset();
+}
+
+FBPDT_BufferPoolStats UBPDT_TableManager::GetBufferPoolStats()
+{
+	return FBPDT_BufferPool::Get().GetStats();
+}
+
+void UBPDT_TableManager::PreloadTables(const TArray<FString>& TableNames)
+{
+	EnsureTablesLoaded(TableNames);
+}
+
+bool UBPDT_TableManager::EnsureTablesLoaded(const TArray<FString>& TableNames)
+{
+	if (!G_BPDT_bLazy)
+	{
+		return true;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+
+	// ---- loaded tables only need their access stamped; the lock is shared ----
+	TArray<FString> Unloaded;
+	{
+		FReadScopeLock PagedLock(G_BPDT_PagedLock);
+
+		for (const FString& Name : TableNames)
+		{
+			if (G_BPDT_UnloadedTables.Contains(Name))
+			{
+				Unloaded.Add(Name);
+			}
+			else if (const TSharedRef<std::atomic<double>>* LastAccess = G_BPDT_LastAccess.Find(Name))
+			{
+				(*LastAccess)->store(Now, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	bool bAllLoaded = true;
+
+	if (Unloaded.Num() > 0)
+	{
+		// ---- claim the tables nobody is loading yet; wait on the others' loads ----
+		TPromise<bool> Promise;
+		TSharedFuture<bool> OurLoad = Promise.GetFuture().Share();
+
+		TArray<FString> ToLoad;
+		TArray<TSharedFuture<bool>> OtherLoads;
+		{
+			FScopeLock LazyLock(&G_BPDT_LazyMutex);
+
+			for (const FString& Name : Unloaded)
+			{
+				if (const TSharedFuture<bool>* InFlight = G_BPDT_LoadingTables.Find(Name))
+				{
+					OtherLoads.Add(*InFlight);
+				}
+				else if (!G_BPDT_UnloadedTables.Contains(Name))
+				{
+					// Loaded meanwhile
+					continue;
+				}
+				else if (Now < G_BPDT_LoadRetryTime.FindRef(Name))
+				{
+					// Failed recently; still registered, so its name stays taken
+					bAllLoaded = false;
+				}
+				else
+				{
+					ToLoad.Add(Name);
+					G_BPDT_LoadingTables.Add(Name, OurLoad);
+				}
+			}
+		}
+
+		if (ToLoad.Num() > 0)
+		{
+			// No lock held across the read
+			TMap<FString, FBPDT_Table> Loaded;
+			const bool bRead = ReadTables(ToLoad, Loaded);
+
+			TArray<FString> Installed;
+			TArray<uint64> InstalledVersions;
+			TArray<uint64> InstalledSchemaVersions;
+			{
+				FScopeLock LazyLock(&G_BPDT_LazyMutex);
+				FWriteScopeLock PagedLock(G_BPDT_PagedLock);
+				FWriteScopeLock MapLock(G_BPDT_TablesLock);
+
+				for (const FString& Name : ToLoad)
+				{
+					G_BPDT_LoadingTables.Remove(Name);
+
+					FBPDT_Table* Table = Loaded.Find(Name);
+
+					// Dropped or loaded explicitly while we read: theirs wins
+					if (!G_BPDT_UnloadedTables.Contains(Name))
+					{
+						continue;
+					}
+
+					// A failed table stays registered and is read again after a while
+					if (!Table)
+					{
+						G_BPDT_LoadRetryTime.Add(Name, Now + BPDT_LOAD_RETRY_SECONDS);
+						continue;
+					}
+
+					MarkForeignKeyColumns(ForeignKeys, Name, *Table);
+
+					G_BPDT_UnloadedTables.Remove(Name);
+					G_BPDT_LoadRetryTime.Remove(Name);
+					G_BPDT_LastAccess.Add(Name, MakeShared<std::atomic<double>>(Now));
+					ForgetPKScan(Name);
+					Installed.Add(Name);
+					InstalledVersions.Add(Table->GetVersion());
+					InstalledSchemaVersions.Add(Table->GetSchemaVersion());
+
+					G_BPDT_Tables.Add(Name, MoveTemp(*Table));
+				}
+			}
+
+			// What is on disk needs no log records; after the locks, the log
+			// comes first in the lock order
+			for (int32 i = 0; i < Installed.Num(); ++i)
+			{
+				FBPDT_WriteAheadLog::Get().NoteLoadedTable(Installed[i], InstalledVersions[i], InstalledSchemaVersions[i]);
+			}
+
+			bAllLoaded &= bRead;
+			Promise.SetValue(bRead);
+		}
+
+		for (const TSharedFuture<bool>& Load : OtherLoads)
+		{
+			bAllLoaded &= Load.Get();
+		}
+	}
+
+	// ---- an open transaction on this thread sees loaded tables from now on ----
+	if (G_BPDT_Transaction && Unloaded.Num() > 0)
+	{
+		FReadScopeLock MapLock(G_BPDT_TablesLock);
+
+		for (const FString& Name : Unloaded)
+		{
+			const FBPDT_Table* Table = G_BPDT_Tables.Find(Name);
+			if (!Table || G_BPDT_Transaction->Tables.Contains(Name) || G_BPDT_Transaction->BaseVersions.Contains(Name))
+			{
+				continue;
+			}
+
+			FReadScopeLock TableLock(Table->GetLock());
+			G_BPDT_Transaction->Tables.Add(Name, Table->MakeSnapshot());
+			G_BPDT_Transaction->BaseVersions.Add(Name, Table->GetVersion());
+		}
+	}
+
+	return bAllLoaded;
+}
+
+bool UBPDT_TableManager::UnloadIdleTables(float DeltaTime)
+{
+	const float IdleSeconds = CVarBPDTLazyUnloadSeconds.GetValueOnGameThread();
+
+	// A transaction's commit expects the tables it copied to still be live
+	if (IdleSeconds <= 0.0f || G_BPDT_OpenTransactions > 0)
+	{
+		return true;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+
+	FScopeLock LazyLock(&G_BPDT_LazyMutex);
+
+	TArray<FString> Idle;
+	for (const auto& Pair : G_BPDT_LastAccess)
+	{
+		if (Now - Pair.Value->load(std::memory_order_relaxed) >= IdleSeconds)
+		{
+			Idle.Add(Pair.Key);
+		}
+	}
+
+	if (Idle.Num() == 0)
+	{
+		return true;
+	}
+
+	FWriteScopeLock PagedLock(G_BPDT_PagedLock);
+	FWriteScopeLock MapLock(G_BPDT_TablesLock);
+
+	for (const FString& Name : Idle)
+	{
+		const FBPDT_Table* Table = G_BPDT_Tables.Find(Name);
+		if (!Table)
+		{
+			G_BPDT_LastAccess.Remove(Name);
+			continue;
+		}
+
+		// Unsaved changes stay in memory until a save
+		if (!FBPDT_FileManager::IsTableSaved(Name, Table->GetVersion()))
+		{
+			continue;
+		}
+
+		G_BPDT_Tables.Remove(Name);
+		G_BPDT_LastAccess.Remove(Name);
+		G_BPDT_UnloadedTables.Add(Name);
+		ForgetPKScan(Name);
+
+		UE_LOG(LogTemp, Verbose, TEXT("[BPDT] Unloaded idle table '%s'."), *Name);
+	}
+
+	return true;
+}
+
+/* ---------------- Snapshots ---------------- */
+
+TSharedRef<const FBPDT_DatabaseSnapshot> UBPDT_TableManager::TakeSnapshot(
+	const TArray<FString>& TableNames
+)
+{
+	// Named tables are loaded if needed; "all" means all loaded tables, the
+	// rest is unchanged on disk
+	EnsureTablesLoaded(TableNames);
+
+	TSharedRef<FBPDT_DatabaseSnapshot> Snapshot = MakeShared<FBPDT_DatabaseSnapshot>();
+
+	if (TableNames.Num() == 1)
+	{
+		// Single table: the map held shared plus the table's read lock is enough.
+		// Snapshots always see committed state, never a transaction's copies.
+		FReadScopeLock MapLock(G_BPDT_TablesLock);
+
+		if (const FBPDT_Table* Table = G_BPDT_Tables.Find(TableNames[0]))
+		{
+			FReadScopeLock TableLock(Table->GetLock());
+			Snapshot->Tables.Add(TableNames[0], Table->MakeSnapshot());
+		}
+		Snapshot->ForeignKeys = ForeignKeys;
+		return Snapshot;
+	}
+
+	// Exclusive map lock: no table scope can be open, so every table is
+	// quiescent and the copies form a single point in time. Copies are
+	// O(columns) each, so the lock is held only briefly.
+	FWriteScopeLock MapLock(G_BPDT_TablesLock);
+
+	if (TableNames.Num() == 0)
+	{
+		Snapshot->Tables.Reserve(G_BPDT_Tables.Num());
+		for (const auto& Pair : G_BPDT_Tables)
+		{
+			Snapshot->Tables.Add(Pair.Key, Pair.Value.MakeSnapshot());
+		}
+		Snapshot->RemovedTables = G_BPDT_RemovedTables;
+	}
+	else
+	{
+		for (const FString& TableName : TableNames)
+		{
+			if (const FBPDT_Table* Table = G_BPDT_Tables.Find(TableName))
+			{
+				Snapshot->Tables.Add(TableName, Table->MakeSnapshot());
+			}
+		}
+	}
+
+	Snapshot->ForeignKeys = ForeignKeys;
+	return Snapshot;
+}
+
+void UBPDT_TableManager::ForEachCommittedTable(
+	const TArray<FString>& TableNames,
+	TFunctionRef<void(const FString&, FBPDT_Table*)> Visitor
+)
+{
+	// Committed state only. Unloaded tables were saved, so they hold
+	// nothing left to log.
+	FReadScopeLock PagedLock(G_BPDT_PagedLock);
+	FReadScopeLock MapLock(G_BPDT_TablesLock);
+
+	for (const FString& TableName : TableNames)
+	{
+		FBPDT_Table* Table = G_BPDT_Tables.Find(TableName);
+		if (!Table)
+		{
+			if (!G_BPDT_UnloadedTables.Contains(TableName))
+			{
+				Visitor(TableName, nullptr);
+			}
+			continue;
+		}
+
+		FWriteScopeLock TableLock(Table->GetLock());
+		Visitor(TableName, Table);
+	}
+}
@@ -0,0 +1,1380 @@
+#include "BPDT_TextIO.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+
+static TAutoConsoleVariable<int32> CVarBPDTTextIOChunkMB(
+	TEXT("BPDT.TextIO.ChunkMB"),
+	16,
+	TEXT("CSV/JSON import: size in MB of each read; every read is parsed in parallel pieces."),
+	ECVF_Default
+);
+
+// Smallest piece of a read that is worth a task of its own
+static constexpr int64 BPDT_MIN_BYTES_PER_PIECE = 256 * 1024;
+
+// Rows formatted per export task
+static constexpr int32 BPDT_EXPORT_ROWS_PER_PIECE = 8192;
+
+static bool IsSpace(uint8 C)
+{
+	return C == ' ' || C == '\t' || C == '\r' || C == '\n';
+}
+
+static void TrimSpaces(const uint8*& Text, int32& Len)
+{
+	while (Len > 0 && IsSpace(Text[0]))
+	{
+		++Text;
+		--Len;
+	}
+	while (Len > 0 && IsSpace(Text[Len - 1]))
+	{
+		--Len;
+	}
+}
+
+// For log messages
+static FString UTF8ToString(const uint8* Text, int32 Len)
+{
+	FUTF8ToTCHAR Conv((const ANSICHAR*)Text, Len);
+	return FString(Conv.Length(), Conv.Get());
+}
+
+/* ===================== Field conversion ===================== */
+
+static bool ParseInt(const uint8* Text, int32 Len, int32& OutValue)
+{
+	TrimSpaces(Text, Len);
+
+	int32 i = 0;
+	bool bNegative = false;
+	if (i < Len && (Text[i] == '-' || Text[i] == '+'))
+	{
+		bNegative = Text[i] == '-';
+		++i;
+	}
+
+	if (i == Len)
+	{
+		return false;
+	}
+
+	int64 Value = 0;
+	for (; i < Len; ++i)
+	{
+		const uint32 Digit = (uint32)Text[i] - '0';
+		if (Digit > 9)
+		{
+			return false;
+		}
+
+		Value = Value * 10 + Digit;
+		if (Value > (int64)MAX_int32 + 1)
+		{
+			return false;
+		}
+	}
+
+	Value = bNegative ? -Value : Value;
+	if (Value > MAX_int32 || Value < MIN_int32)
+	{
+		return false;
+	}
+
+	OutValue = (int32)Value;
+	return true;
+}
+
+static bool ParseDouble(const uint8* Text, int32 Len, double& OutValue)
+{
+	TrimSpaces(Text, Len);
+
+	// Atod wants a terminated string; numbers are short, so copy to the stack
+	ANSICHAR Buffer[64];
+	if (Len <= 0 || Len >= UE_ARRAY_COUNT(Buffer))
+	{
+		return false;
+	}
+
+	bool bDigit = false;
+	for (int32 i = 0; i < Len; ++i)
+	{
+		const uint8 C = Text[i];
+		if (C >= '0' && C <= '9')
+		{
+			bDigit = true;
+		}
+		else if (C != '+' && C != '-' && C != '.' && C != 'e' && C != 'E')
+		{
+			return false;
+		}
+		Buffer[i] = (ANSICHAR)C;
+	}
+	Buffer[Len] = 0;
+
+	OutValue = FCStringAnsi::Atod(Buffer);
+	return bDigit;
+}
+
+static bool ParseBool(const uint8* Text, int32 Len, bool& OutValue)
+{
+	TrimSpaces(Text, Len);
+
+	auto Equals = [Text, Len](const ANSICHAR* Word)
+	{
+		const int32 WordLen = FCStringAnsi::Strlen(Word);
+		return WordLen == Len
+			&& FCStringAnsi::Strnicmp((const ANSICHAR*)Text, Word, Len) == 0;
+	};
+
+	if (Equals("true") || Equals("1"))
+	{
+		OutValue = true;
+		return true;
+	}
+	if (Equals("false") || Equals("0"))
+	{
+		OutValue = false;
+		return true;
+	}
+	return false;
+}
+
+// "X Y Z", "X,Y,Z", FVector::ToString's "X=.. Y=.. Z=.." or the inside of [X, Y, Z]
+static bool ParseVector(const uint8* Text, int32 Len, FVector& OutValue)
+{
+	int32 i = 0;
+
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		while (i < Len && (IsSpace(Text[i]) || Text[i] == ','))
+		{
+			++i;
+		}
+
+		if (i + 1 < Len && Text[i + 1] == '=')
+		{
+			i += 2;
+		}
+
+		const int32 Begin = i;
+		while (i < Len && !IsSpace(Text[i]) && Text[i] != ',')
+		{
+			++i;
+		}
+
+		double Value = 0.0;
+		if (!ParseDouble(Text + Begin, i - Begin, Value))
+		{
+			return false;
+		}
+		OutValue[Axis] = Value;
+	}
+
+	while (i < Len && IsSpace(Text[i]))
+	{
+		++i;
+	}
+	return i == Len;
+}
+
+static FBPDT_Cell MakeEmptyString()
+{
+	FBPDT_Cell Cell;
+	Cell.Type = EBPDT_CellType::String;
+	Cell.bIsNull = false;
+	return Cell;
+}
+
+/* Converts the UTF-8 text of one non-null field into a cell of the column's type */
+static bool ParseCell(EBPDT_CellType Type, const uint8* Text, int32 Len, FBPDT_Cell& OutCell)
+{
+	switch (Type)
+	{
+	case EBPDT_CellType::Int:
+	{
+		int32 Value = 0;
+		if (!ParseInt(Text, Len, Value))
+		{
+			return false;
+		}
+		OutCell = FBPDT_Cell(Type, &Value, sizeof(int32));
+		return true;
+	}
+	case EBPDT_CellType::Float:
+	{
+		double Value = 0.0;
+		if (!ParseDouble(Text, Len, Value))
+		{
+			return false;
+		}
+		const float FloatValue = (float)Value;
+		OutCell = FBPDT_Cell(Type, &FloatValue, sizeof(float));
+		return true;
+	}
+	case EBPDT_CellType::Bool:
+	{
+		bool Value = false;
+		if (!ParseBool(Text, Len, Value))
+		{
+			return false;
+		}
+		OutCell = FBPDT_Cell(Type, &Value, sizeof(bool));
+		return true;
+	}
+	case EBPDT_CellType::Vector3:
+	{
+		FVector Value = FVector::ZeroVector;
+		if (!ParseVector(Text, Len, Value))
+		{
+			return false;
+		}
+		OutCell = FBPDT_Cell(Type, &Value, sizeof(FVector));
+		return true;
+	}
+	case EBPDT_CellType::String:
+		OutCell = Len > 0 ? FBPDT_Cell(Type, Text, Len) : MakeEmptyString();
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* ===================== Import ===================== */
+
+/* What a piece parser needs to know about the target table and the file */
+struct FBPDT_TextSchema
+{
+	const TArray<FBPDT_Column>* Columns = nullptr;
+
+	// Per column: what a row gets when the file has no value for it
+	TArray<FBPDT_Cell> Defaults;
+
+	// Per column, UTF-8, for matching header fields and JSON keys
+	TArray<TArray<uint8>> Names;
+
+	// CSV: column of each header field, and the columns the header lacks
+	TArray<int32> FieldColumns;
+	TArray<int32> MissingColumns;
+
+	int32 FindColumn(const uint8* Name, int32 Len) const
+	{
+		for (int32 i = 0; i < Names.Num(); ++i)
+		{
+			if (Names[i].Num() == Len && FMemory::Memcmp(Names[i].GetData(), Name, Len) == 0)
+			{
+				return i;
+			}
+		}
+		return INDEX_NONE;
+	}
+
+	EBPDT_CellType GetType(int32 ColumnIndex) const
+	{
+		return (*Columns)[ColumnIndex].Type;
+	}
+};
+
+static void InitTextSchema(
+	const TArray<FBPDT_Column>& Columns,
+	int32 AssignedColumn,
+	FBPDT_TextSchema& OutSchema
+)
+{
+	OutSchema.Columns = &Columns;
+	OutSchema.Defaults.Reset(Columns.Num());
+	OutSchema.Names.Reset(Columns.Num());
+
+	for (int32 i = 0; i < Columns.Num(); ++i)
+	{
+		const FBPDT_Column& Col = Columns[i];
+
+		if (i == AssignedColumn)
+		{
+			OutSchema.Defaults.Add(FBPDT_Cell::MakeNull(Col.Type));
+		}
+		else if (Col.ByteSize > 0)
+		{
+			OutSchema.Defaults.Emplace(Col.Type, Col.DefaultData.GetData(), Col.ByteSize);
+		}
+		else
+		{
+			// Only strings have a zero-length default
+			OutSchema.Defaults.Add(MakeEmptyString());
+		}
+
+		FTCHARToUTF8 Name(*Col.Name.ToString());
+		OutSchema.Names.Emplace((const uint8*)Name.Get(), Name.Length());
+	}
+}
+
+/* ---------------- Record boundaries ---------------- */
+
+/**
+ * Scans Data, which starts at a record boundary, for record ends. A cut is
+ * placed at the first record end past every Step bytes, and one more at the
+ * last record end (none if no record is complete). JSON records are the
+ * elements of the top-level array; Depth is the nesting at Data[0].
+ */
+static void FindRecordCuts(
+	const uint8* Data,
+	int64 Size,
+	EBPDT_TextFormat Format,
+	int32 Depth,
+	int64 Step,
+	TArray<int64>& OutCuts
+)
+{
+	OutCuts.Reset();
+
+	int64 NextCut = Step;
+	int64 LastEnd = 0;
+
+	auto RecordEnd = [&](int64 End)
+	{
+		LastEnd = End;
+		if (End >= NextCut)
+		{
+			OutCuts.Add(End);
+			NextCut = End + Step;
+		}
+	};
+
+	if (Format == EBPDT_TextFormat::CSV)
+	{
+		bool bInQuotes = false;
+		for (int64 i = 0; i < Size; ++i)
+		{
+			const uint8 C = Data[i];
+			if (C == '"')
+			{
+				// An escaped "" toggles twice
+				bInQuotes = !bInQuotes;
+			}
+			else if (C == '\n' && !bInQuotes)
+			{
+				RecordEnd(i + 1);
+			}
+		}
+	}
+	else
+	{
+		bool bInString = false;
+		for (int64 i = 0; i < Size; ++i)
+		{
+			const uint8 C = Data[i];
+			if (bInString)
+			{
+				if (C == '\\')
+				{
+					++i;
+				}
+				else if (C == '"')
+				{
+					bInString = false;
+				}
+				continue;
+			}
+
+			switch (C)
+			{
+			case '"':
+				bInString = true;
+				break;
+			case '{':
+			case '[':
+				++Depth;
+				break;
+			case '}':
+			case ']':
+				if (--Depth == 1)
+				{
+					RecordEnd(i + 1);
+				}
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	if (LastEnd > 0 && (OutCuts.Num() == 0 || OutCuts.Last() != LastEnd))
+	{
+		OutCuts.Add(LastEnd);
+	}
+}
+
+/* ---------------- CSV ---------------- */
+
+/**
+ * Reads one field at Pos, leaving Pos on the separator after it. Quoted
+ * fields are unescaped into Scratch. bOutNull for an empty unquoted field.
+ */
+static bool ReadCSVField(
+	const uint8* Data,
+	int64 Size,
+	int64& Pos,
+	TArray<uint8>& Scratch,
+	const uint8*& OutText,
+	int32& OutLen,
+	bool& bOutNull
+)
+{
+	if (Pos < Size && Data[Pos] == '"')
+	{
+		++Pos;
+		Scratch.Reset();
+
+		for (;;)
+		{
+			// Copy up to the next quote in one go
+			const int64 Begin = Pos;
+			while (Pos < Size && Data[Pos] != '"')
+			{
+				++Pos;
+			}
+			Scratch.Append(Data + Begin, Pos - Begin);
+
+			if (Pos >= Size)
+			{
+				return false;
+			}
+
+			++Pos;
+			if (Pos < Size && Data[Pos] == '"')
+			{
+				Scratch.Add('"');
+				++Pos;
+				continue;
+			}
+			break;
+		}
+
+		if (Pos < Size && Data[Pos] == '\r')
+		{
+			++Pos;
+		}
+
+		OutText = Scratch.GetData();
+		OutLen = Scratch.Num();
+		bOutNull = false;
+		return true;
+	}
+
+	const int64 Begin = Pos;
+	while (Pos < Size && Data[Pos] != ',' && Data[Pos] != '\n')
+	{
+		++Pos;
+	}
+
+	int64 End = Pos;
+	if (End > Begin && Data[End - 1] == '\r')
+	{
+		--End;
+	}
+
+	OutText = Data + Begin;
+	OutLen = (int32)(End - Begin);
+	bOutNull = OutLen == 0;
+	return true;
+}
+
+static bool ParseCSVPiece(
+	const uint8* Data,
+	int64 Size,
+	const FBPDT_TextSchema& Schema,
+	TArray<FBPDT_Row>& OutRows,
+	int64& OutErrorOffset
+)
+{
+	TArray<uint8> Scratch;
+	const int32 FieldCount = Schema.FieldColumns.Num();
+
+	int64 Pos = 0;
+	while (Pos < Size)
+	{
+		// Blank lines carry no record
+		if (Data[Pos] == '\n' || (Data[Pos] == '\r' && Pos + 1 < Size && Data[Pos + 1] == '\n'))
+		{
+			Pos += Data[Pos] == '\r' ? 2 : 1;
+			continue;
+		}
+
+		const int64 RecordStart = Pos;
+		FBPDT_Row Row(Schema.Defaults.Num());
+
+		for (int32 Field = 0; ; ++Field)
+		{
+			const uint8* Text = nullptr;
+			int32 Len = 0;
+			bool bNull = false;
+
+			if (Field >= FieldCount || !ReadCSVField(Data, Size, Pos, Scratch, Text, Len, bNull))
+			{
+				OutErrorOffset = RecordStart;
+				return false;
+			}
+
+			const int32 ColumnIndex = Schema.FieldColumns[Field];
+			FBPDT_Cell& Cell = Row.Cells[ColumnIndex];
+
+			if (bNull)
+			{
+				Cell = FBPDT_Cell::MakeNull(Schema.GetType(ColumnIndex));
+			}
+			else if (!ParseCell(Schema.GetType(ColumnIndex), Text, Len, Cell))
+			{
+				OutErrorOffset = RecordStart;
+				return false;
+			}
+
+			if (Pos >= Size || Data[Pos] == '\n')
+			{
+				++Pos;
+				if (Field + 1 != FieldCount)
+				{
+					OutErrorOffset = RecordStart;
+					return false;
+				}
+				break;
+			}
+
+			if (Data[Pos] != ',')
+			{
+				OutErrorOffset = RecordStart;
+				return false;
+			}
+			++Pos;
+		}
+
+		for (const int32 ColumnIndex : Schema.MissingColumns)
+		{
+			Row.Cells[ColumnIndex] = Schema.Defaults[ColumnIndex];
+		}
+
+		OutRows.Add(MoveTemp(Row));
+	}
+
+	return true;
+}
+
+/* Maps the header record onto the columns; Pos moves past it */
+static bool ParseCSVHeader(
+	const uint8* Data,
+	int64 Size,
+	int64& Pos,
+	FBPDT_TextSchema& Schema
+)
+{
+	TArray<uint8> Scratch;
+	TArray<bool> bSeen;
+	bSeen.Init(false, Schema.Names.Num());
+
+	Schema.FieldColumns.Reset();
+	Schema.MissingColumns.Reset();
+
+	for (;;)
+	{
+		const uint8* Text = nullptr;
+		int32 Len = 0;
+		bool bNull = false;
+		if (!ReadCSVField(Data, Size, Pos, Scratch, Text, Len, bNull))
+		{
+			return false;
+		}
+
+		TrimSpaces(Text, Len);
+
+		const int32 ColumnIndex = Schema.FindColumn(Text, Len);
+		if (ColumnIndex == INDEX_NONE || bSeen[ColumnIndex])
+		{
+			UE_LOG(LogTemp, Warning,
+				TEXT("[BPDT] CSV header names unknown or repeated column '%s'."),
+				*UTF8ToString(Text, Len));
+			return false;
+		}
+
+		bSeen[ColumnIndex] = true;
+		Schema.FieldColumns.Add(ColumnIndex);
+
+		if (Pos >= Size || Data[Pos] == '\n')
+		{
+			++Pos;
+			break;
+		}
+		if (Data[Pos] != ',')
+		{
+			return false;
+		}
+		++Pos;
+	}
+
+	for (int32 i = 0; i < bSeen.Num(); ++i)
+	{
+		if (!bSeen[i])
+		{
+			Schema.MissingColumns.Add(i);
+		}
+	}
+
+	return true;
+}
+
+/* ---------------- JSON ---------------- */
+
+static void AppendUTF8(uint32 CodePoint, TArray<uint8>& Out)
+{
+	if (CodePoint < 0x80)
+	{
+		Out.Add((uint8)CodePoint);
+	}
+	else if (CodePoint < 0x800)
+	{
+		Out.Add((uint8)(0xC0 | (CodePoint >> 6)));
+		Out.Add((uint8)(0x80 | (CodePoint & 0x3F)));
+	}
+	else if (CodePoint < 0x10000)
+	{
+		Out.Add((uint8)(0xE0 | (CodePoint >> 12)));
+		Out.Add((uint8)(0x80 | ((CodePoint >> 6) & 0x3F)));
+		Out.Add((uint8)(0x80 | (CodePoint & 0x3F)));
+	}
+	else
+	{
+		Out.Add((uint8)(0xF0 | (CodePoint >> 18)));
+		Out.Add((uint8)(0x80 | ((CodePoint >> 12) & 0x3F)));
+		Out.Add((uint8)(0x80 | ((CodePoint >> 6) & 0x3F)));
+		Out.Add((uint8)(0x80 | (CodePoint & 0x3F)));
+	}
+}
+
+static bool ReadHex4(const uint8* Data, int64 Size, int64& Pos, uint32& OutValue)
+{
+	if (Pos + 4 > Size)
+	{
+		return false;
+	}
+
+	OutValue = 0;
+	for (int32 i = 0; i < 4; ++i)
+	{
+		const uint8 C = Data[Pos++];
+		uint32 Digit;
+		if (C >= '0' && C <= '9')      Digit = C - '0';
+		else if (C >= 'a' && C <= 'f') Digit = C - 'a' + 10;
+		else if (C >= 'A' && C <= 'F') Digit = C - 'A' + 10;
+		else return false;
+
+		OutValue = (OutValue << 4) | Digit;
+	}
+	return true;
+}
+
+/* Data[Pos] is the opening quote; the unescaped UTF-8 goes to Out */
+static bool ReadJSONString(const uint8* Data, int64 Size, int64& Pos, TArray<uint8>& Out)
+{
+	Out.Reset();
+	++Pos;
+
+	while (Pos < Size)
+	{
+		// Copy up to the next quote or escape in one go
+		const int64 Begin = Pos;
+		while (Pos < Size && Data[Pos] != '"' && Data[Pos] != '\\')
+		{
+			++Pos;
+		}
+		Out.Append(Data + Begin, Pos - Begin);
+
+		if (Pos >= Size)
+		{
+			return false;
+		}
+
+		if (Data[Pos++] == '"')
+		{
+			return true;
+		}
+
+		if (Pos >= Size)
+		{
+			return false;
+		}
+
+		switch (Data[Pos++])
+		{
+		case '"':  Out.Add('"');  break;
+		case '\\': Out.Add('\\'); break;
+		case '/':  Out.Add('/');  break;
+		case 'b':  Out.Add('\b'); break;
+		case 'f':  Out.Add('\f'); break;
+		case 'n':  Out.Add('\n'); break;
+		case 'r':  Out.Add('\r'); break;
+		case 't':  Out.Add('\t'); break;
+		case 'u':
+		{
+			uint32 CodePoint = 0;
+			if (!ReadHex4(Data, Size, Pos, CodePoint))
+			{
+				return false;
+			}
+
+			if (CodePoint >= 0xD800 && CodePoint <= 0xDBFF)
+			{
+				// Surrogate pair
+				uint32 Low = 0;
+				if (Pos + 2 > Size || Data[Pos] != '\\' || Data[Pos + 1] != 'u')
+				{
+					return false;
+				}
+				Pos += 2;
+				if (!ReadHex4(Data, Size, Pos, Low) || Low < 0xDC00 || Low > 0xDFFF)
+				{
+					return false;
+				}
+				CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (Low - 0xDC00);
+			}
+			else if (CodePoint >= 0xDC00 && CodePoint <= 0xDFFF)
+			{
+				return false;
+			}
+
+			AppendUTF8(CodePoint, Out);
+			break;
+		}
+		default:
+			return false;
+		}
+	}
+
+	return false;
+}
+
+static void SkipSpaces(const uint8* Data, int64 Size, int64& Pos)
+{
+	while (Pos < Size && IsSpace(Data[Pos]))
+	{
+		++Pos;
+	}
+}
+
+/* One value at Pos into the column's cell */
+static bool ReadJSONValue(
+	const uint8* Data,
+	int64 Size,
+	int64& Pos,
+	EBPDT_CellType Type,
+	TArray<uint8>& Scratch,
+	FBPDT_Cell& OutCell
+)
+{
+	if (Pos >= Size)
+	{
+		return false;
+	}
+
+	if (Data[Pos] == '"')
+	{
+		if (!ReadJSONString(Data, Size, Pos, Scratch))
+		{
+			return false;
+		}
+		return ParseCell(Type, Scratch.GetData(), Scratch.Num(), OutCell);
+	}
+
+	if (Data[Pos] == '[')
+	{
+		const int64 Begin = ++Pos;
+		while (Pos < Size && Data[Pos] != ']')
+		{
+			++Pos;
+		}
+		if (Pos >= Size || Type != EBPDT_CellType::Vector3)
+		{
+			return false;
+		}
+
+		const int32 Len = (int32)(Pos - Begin);
+		++Pos;
+		return ParseCell(Type, Data + Begin, Len, OutCell);
+	}
+
+	// Bare token: number, true, false or null
+	const int64 Begin = Pos;
+	while (Pos < Size && Data[Pos] != ',' && Data[Pos] != '}' && !IsSpace(Data[Pos]))
+	{
+		++Pos;
+	}
+
+	const int32 Len = (int32)(Pos - Begin);
+	if (Len == 4 && FMemory::Memcmp(Data + Begin, "null", 4) == 0)
+	{
+		OutCell = FBPDT_Cell::MakeNull(Type);
+		return true;
+	}
+
+	return Len > 0 && ParseCell(Type, Data + Begin, Len, OutCell);
+}
+
+static bool ParseJSONPiece(
+	const uint8* Data,
+	int64 Size,
+	const FBPDT_TextSchema& Schema,
+	TArray<FBPDT_Row>& OutRows,
+	int64& OutErrorOffset
+)
+{
+	TArray<uint8> Key;
+	TArray<uint8> Scratch;
+	TArray<bool> bSeen;
+
+	const int32 ColumnCount = Schema.Defaults.Num();
+
+	int64 Pos = 0;
+	for (;;)
+	{
+		// Between records: the array's brackets and separators
+		while (Pos < Size && (IsSpace(Data[Pos]) || Data[Pos] == ',' || Data[Pos] == '[' || Data[Pos] == ']'))
+		{
+			++Pos;
+		}
+
+		if (Pos >= Size)
+		{
+			return true;
+		}
+
+		const int64 RecordStart = Pos;
+		auto Fail = [&OutErrorOffset, RecordStart]()
+		{
+			OutErrorOffset = RecordStart;
+			return false;
+		};
+
+		if (Data[Pos++] != '{')
+		{
+			return Fail();
+		}
+
+		FBPDT_Row Row(ColumnCount);
+		bSeen.Init(false, ColumnCount);
+
+		SkipSpaces(Data, Size, Pos);
+		if (Pos < Size && Data[Pos] == '}')
+		{
+			++Pos;
+		}
+		else
+		{
+			for (;;)
+			{
+				SkipSpaces(Data, Size, Pos);
+				if (Pos >= Size || Data[Pos] != '"' || !ReadJSONString(Data, Size, Pos, Key))
+				{
+					return Fail();
+				}
+
+				const int32 ColumnIndex = Schema.FindColumn(Key.GetData(), Key.Num());
+				if (ColumnIndex == INDEX_NONE)
+				{
+					UE_LOG(LogTemp, Warning,
+						TEXT("[BPDT] JSON object names unknown column '%s'."),
+						*UTF8ToString(Key.GetData(), Key.Num()));
+					return Fail();
+				}
+
+				SkipSpaces(Data, Size, Pos);
+				if (Pos >= Size || Data[Pos++] != ':')
+				{
+					return Fail();
+				}
+				SkipSpaces(Data, Size, Pos);
+
+				if (!ReadJSONValue(Data, Size, Pos, Schema.GetType(ColumnIndex), Scratch, Row.Cells[ColumnIndex]))
+				{
+					return Fail();
+				}
+				bSeen[ColumnIndex] = true;
+
+				SkipSpaces(Data, Size, Pos);
+				if (Pos >= Size)
+				{
+					return Fail();
+				}
+				if (Data[Pos] == ',')
+				{
+					++Pos;
+					continue;
+				}
+				if (Data[Pos] == '}')
+				{
+					++Pos;
+					break;
+				}
+				return Fail();
+			}
+		}
+
+		for (int32 i = 0; i < ColumnCount; ++i)
+		{
+			if (!bSeen[i])
+			{
+				Row.Cells[i] = Schema.Defaults[i];
+			}
+		}
+
+		OutRows.Add(MoveTemp(Row));
+	}
+}
+
+/* ---------------- Driver ---------------- */
+
+bool FBPDT_TextIO::ImportRows(
+	const FString& Path,
+	EBPDT_TextFormat Format,
+	const TArray<FBPDT_Column>& Columns,
+	int32 AssignedColumn,
+	TArray<FBPDT_Row>& OutRows
+)
+{
+	OutRows.Reset();
+
+	IPlatformFile& PF = FPlatformFileManager::Get().GetPlatformFile();
+	TUniquePtr<IFileHandle> File(PF.OpenRead(*Path));
+	if (!File)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[BPDT] Cannot open '%s' for import."), *Path);
+		return false;
+	}
+
+	FBPDT_TextSchema Schema;
+	InitTextSchema(Columns, AssignedColumn, Schema);
+
+	const int64 FileSize = File->Size();
+	const int64 ChunkBytes = (int64)FMath::Max(CVarBPDTTextIOChunkMB.GetValueOnAnyThread(), 1) * 1024 * 1024;
+	const int32 MaxPieces = FBPDT_Table::GetMaxParallelChunks();
+
+	// Unparsed tail of the previous read followed by the next read
+	TArray<uint8> Buffer;
+	int64 FileOffset = 0;
+
+	bool bStarted = false;
+	int32 Depth = 0;
+
+	TArray<int64> Cuts;
+	TArray<TArray<FBPDT_Row>> PieceRows;
+	TArray<int64> PieceErrors;
+
+	for (;;)
+	{
+		const int64 ToRead = FMath::Min(ChunkBytes, FileSize - FileOffset);
+		const int64 Carried = Buffer.Num();
+
+		Buffer.SetNumUninitialized(Carried + ToRead, EAllowShrinking::No);
+		if (ToRead > 0 && !File->Read(Buffer.GetData() + Carried, ToRead))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[BPDT] Read error in '%s'."), *Path);
+			return false;
+		}
+		FileOffset += ToRead;
+
+		const bool bLast = FileOffset >= FileSize;
+		const int64 BufferFileOffset = FileOffset - Buffer.Num();
+
+		const uint8* Data = Buffer.GetData();
+		const int64 Size = Buffer.Num();
+		int64 Start = 0;
+
+		if (!bStarted)
+		{
+			// Wait for a whole CSV header; JSON only needs its first byte
+			if (Format == EBPDT_TextFormat::CSV && !bLast
+				&& !Buffer.Contains('\n'))
+			{
+				continue;
+			}
+
+			// UTF-8 byte order mark
+			if (Size >= 3 && Data[0] == 0xEF && Data[1] == 0xBB && Data[2] == 0xBF)
+			{
+				Start = 3;
+			}
+
+			if (Format == EBPDT_TextFormat::CSV)
+			{
+				if (Start >= Size || !ParseCSVHeader(Data, Size, Start, Schema))
+				{
+					UE_LOG(LogTemp, Warning, TEXT("[BPDT] '%s' has no valid CSV header."), *Path);
+					return false;
+				}
+			}
+			else
+			{
+				SkipSpaces(Data, Size, Start);
+				if (Start >= Size || Data[Start] != '[')
+				{
+					UE_LOG(LogTemp, Warning, TEXT("[BPDT] '%s' is not a JSON array."), *Path);
+					return false;
+				}
+			}
+
+			bStarted = true;
+		}
+
+		const int64 Step = FMath::Max((Size - Start) / MaxPieces, BPDT_MIN_BYTES_PER_PIECE);
+		FindRecordCuts(Data + Start, Size - Start, Format, Depth, Step, Cuts);
+
+		// The end of the file ends the last record too
+		const int64 Remaining = Size - Start;
+		if (bLast && Remaining > 0 && (Cuts.Num() == 0 || Cuts.Last() != Remaining))
+		{
+			Cuts.Add(Remaining);
+		}
+
+		PieceRows.SetNum(Cuts.Num());
+		PieceErrors.Init(INDEX_NONE, Cuts.Num());
+
+		ParallelFor(Cuts.Num(), [&](int32 Piece)
+		{
+			const int64 Begin = Start + (Piece > 0 ? Cuts[Piece - 1] : 0);
+			const int64 End = Start + Cuts[Piece];
+
+			TArray<FBPDT_Row>& Rows = PieceRows[Piece];
+			Rows.Reset();
+
+			int64 ErrorOffset = 0;
+			const bool bParsed = Format == EBPDT_TextFormat::CSV
+				? ParseCSVPiece(Data + Begin, End - Begin, Schema, Rows, ErrorOffset)
+				: ParseJSONPiece(Data + Begin, End - Begin, Schema, Rows, ErrorOffset);
+
+			if (!bParsed)
+			{
+				PieceErrors[Piece] = Begin + ErrorOffset;
+			}
+		});
+
+		for (int32 Piece = 0; Piece < Cuts.Num(); ++Piece)
+		{
+			if (PieceErrors[Piece] != INDEX_NONE)
+			{
+				UE_LOG(LogTemp, Warning,
+					TEXT("[BPDT] Import of '%s' failed: malformed record at byte %lld."),
+					*Path,
+					BufferFileOffset + PieceErrors[Piece]);
+				return false;
+			}
+
+			if (OutRows.Num() == 0)
+			{
+				OutRows = MoveTemp(PieceRows[Piece]);
+			}
+			else
+			{
+				OutRows.Append(MoveTemp(PieceRows[Piece]));
+			}
+		}
+
+		const int64 Consumed = Start + (Cuts.Num() > 0 ? Cuts.Last() : 0);
+		if (Consumed > Start && Format == EBPDT_TextFormat::JSON)
+		{
+			// Past the first record we are inside the top-level array
+			Depth = 1;
+		}
+
+		Buffer.RemoveAt(0, Consumed, EAllowShrinking::No);
+
+		if (bLast)
+		{
+			break;
+		}
+	}
+
+	return true;
+}
+
+/* ===================== Export ===================== */
+
+static void AppendBytes(TArray<uint8>& Out, const void* Data, int32 Len)
+{
+	Out.Append((const uint8*)Data, Len);
+}
+
+static void AppendLiteral(TArray<uint8>& Out, const ANSICHAR* Text)
+{
+	AppendBytes(Out, Text, FCStringAnsi::Strlen(Text));
+}
+
+static void AppendCSVString(TArray<uint8>& Out, const uint8* Text, int32 Len)
+{
+	// An empty string is quoted so it reads back as empty, not null
+	bool bQuote = Len == 0;
+	for (int32 i = 0; i < Len && !bQuote; ++i)
+	{
+		const uint8 C = Text[i];
+		bQuote = C == ',' || C == '"' || C == '\n' || C == '\r';
+	}
+
+	if (!bQuote)
+	{
+		AppendBytes(Out, Text, Len);
+		return;
+	}
+
+	Out.Add('"');
+	for (int32 i = 0; i < Len; ++i)
+	{
+		if (Text[i] == '"')
+		{
+			Out.Add('"');
+		}
+		Out.Add(Text[i]);
+	}
+	Out.Add('"');
+}
+
+static void AppendJSONString(TArray<uint8>& Out, const uint8* Text, int32 Len)
+{
+	Out.Add('"');
+
+	int32 Begin = 0;
+	for (int32 i = 0; i < Len; ++i)
+	{
+		const uint8 C = Text[i];
+		if (C >= 0x20 && C != '"' && C != '\\')
+		{
+			continue;
+		}
+
+		AppendBytes(Out, Text + Begin, i - Begin);
+		Begin = i + 1;
+
+		switch (C)
+		{
+		case '"':  AppendLiteral(Out, "\\\""); break;
+		case '\\': AppendLiteral(Out, "\\\\"); break;
+		case '\n': AppendLiteral(Out, "\\n");  break;
+		case '\r': AppendLiteral(Out, "\\r");  break;
+		case '\t': AppendLiteral(Out, "\\t");  break;
+		default:
+		{
+			ANSICHAR Escape[8];
+			const int32 EscapeLen = FCStringAnsi::Snprintf(Escape, UE_ARRAY_COUNT(Escape), "\\u%04x", (uint32)C);
+			AppendBytes(Out, Escape, EscapeLen);
+			break;
+		}
+		}
+	}
+	AppendBytes(Out, Text + Begin, Len - Begin);
+
+	Out.Add('"');
+}
+
+static void AppendCell(TArray<uint8>& Out, EBPDT_TextFormat Format, const FBPDT_Cell& Cell)
+{
+	const bool bJSON = Format == EBPDT_TextFormat::JSON;
+
+	auto AppendNull = [&Out, bJSON]()
+	{
+		if (bJSON)
+		{
+			AppendLiteral(Out, "null");
+		}
+	};
+
+	if (Cell.bIsNull)
+	{
+		AppendNull();
+		return;
+	}
+
+	ANSICHAR Buffer[96];
+	int32 Len = 0;
+
+	switch (Cell.Type)
+	{
+	case EBPDT_CellType::Int:
+		Len = FCStringAnsi::Snprintf(Buffer, UE_ARRAY_COUNT(Buffer), "%d", Cell.AsInt());
+		break;
+	case EBPDT_CellType::Float:
+	{
+		const float Value = Cell.AsFloat();
+		if (!FMath::IsFinite(Value))
+		{
+			AppendNull();
+			return;
+		}
+		// 9 significant digits round-trip any float
+		Len = FCStringAnsi::Snprintf(Buffer, UE_ARRAY_COUNT(Buffer), "%.9g", (double)Value);
+		break;
+	}
+	case EBPDT_CellType::Bool:
+		AppendLiteral(Out, Cell.AsBool() ? "true" : "false");
+		return;
+	case EBPDT_CellType::Vector3:
+	{
+		const FVector Value = Cell.AsVector3();
+		if (Value.ContainsNaN())
+		{
+			AppendNull();
+			return;
+		}
+		Len = bJSON
+			? FCStringAnsi::Snprintf(Buffer, UE_ARRAY_COUNT(Buffer), "[%.17g,%.17g,%.17g]", Value.X, Value.Y, Value.Z)
+			: FCStringAnsi::Snprintf(Buffer, UE_ARRAY_COUNT(Buffer), "%.17g %.17g %.17g", Value.X, Value.Y, Value.Z);
+		break;
+	}
+	case EBPDT_CellType::String:
+		if (bJSON)
+		{
+			AppendJSONString(Out, Cell.Data.GetData(), Cell.Data.Num());
+		}
+		else
+		{
+			AppendCSVString(Out, Cell.Data.GetData(), Cell.Data.Num());
+		}
+		return;
+	default:
+		AppendNull();
+		return;
+	}
+
+	AppendBytes(Out, Buffer, Len);
+}
+
+static void AppendRow(
+	TArray<uint8>& Out,
+	EBPDT_TextFormat Format,
+	const TArray<TArray<uint8>>& Names,
+	const FBPDT_Table& Table,
+	int32 RowIndex
+)
+{
+	const FBPDT_Row& Row = Table.GetRowAt(RowIndex);
+
+	if (Format == EBPDT_TextFormat::CSV)
+	{
+		for (int32 i = 0; i < Names.Num(); ++i)
+		{
+			if (i > 0)
+			{
+				Out.Add(',');
+			}
+			AppendCell(Out, Format, Table.GetCell(Row, i));
+		}
+		Out.Add('\n');
+		return;
+	}
+
+	AppendLiteral(Out, RowIndex == 0 ? "\n\t{" : ",\n\t{");
+	for (int32 i = 0; i < Names.Num(); ++i)
+	{
+		if (i > 0)
+		{
+			Out.Add(',');
+		}
+		AppendJSONString(Out, Names[i].GetData(), Names[i].Num());
+		Out.Add(':');
+		AppendCell(Out, Format, Table.GetCell(Row, i));
+	}
+	Out.Add('}');
+}
+
+bool FBPDT_TextIO::ExportRows(
+	const FString& Path,
+	EBPDT_TextFormat Format,
+	const FBPDT_Table& Table
+)
+{
+	IPlatformFile& PF = FPlatformFileManager::Get().GetPlatformFile();
+	PF.CreateDirectoryTree(*FPaths::GetPath(Path));
+
+	TUniquePtr<IFileHandle> File(PF.OpenWrite(*Path));
+	if (!File)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[BPDT] Cannot open '%s' for export."), *Path);
+		return false;
+	}
+
+	const TArray<FBPDT_Column>& Columns = Table.GetColumns();
+
+	TArray<TArray<uint8>> Names;
+	Names.Reserve(Columns.Num());
+	for (const FBPDT_Column& Col : Columns)
+	{
+		FTCHARToUTF8 Name(*Col.Name.ToString());
+		Names.Emplace((const uint8*)Name.Get(), Name.Length());
+	}
+
+	// ---- header ----
+	TArray<uint8> Header;
+	if (Format == EBPDT_TextFormat::CSV)
+	{
+		for (int32 i = 0; i < Names.Num(); ++i)
+		{
+			if (i > 0)
+			{
+				Header.Add(',');
+			}
+			AppendCSVString(Header, Names[i].GetData(), Names[i].Num());
+		}
+		Header.Add('\n');
+	}
+	else
+	{
+		Header.Add('[');
+	}
+
+	if (!File->Write(Header.GetData(), Header.Num()))
+	{
+		return false;
+	}
+
+	// ---- rows: a window of pieces formatted in parallel, written in order ----
+	const int32 RowCount = Table.GetRowCount();
+	const int32 PieceCount = FMath::DivideAndRoundUp(RowCount, BPDT_EXPORT_ROWS_PER_PIECE);
+	const int32 Window = FBPDT_Table::GetMaxParallelChunks();
+
+	TArray<TArray<uint8>> Buffers;
+	Buffers.SetNum(FMath::Min(PieceCount, Window));
+
+	for (int32 First = 0; First < PieceCount; First += Window)
+	{
+		const int32 Count = FMath::Min(Window, PieceCount - First);
+
+		ParallelFor(Count, [&](int32 Slot)
+		{
+			const int32 Begin = (First + Slot) * BPDT_EXPORT_ROWS_PER_PIECE;
+			const int32 End = FMath::Min(Begin + BPDT_EXPORT_ROWS_PER_PIECE, RowCount);
+
+			TArray<uint8>& Out = Buffers[Slot];
+			Out.Reset();
+
+			for (int32 RowIndex = Begin; RowIndex < End; ++RowIndex)
+			{
+				AppendRow(Out, Format, Names, Table, RowIndex);
+			}
+		});
+
+		for (int32 Slot = 0; Slot < Count; ++Slot)
+		{
+			if (!File->Write(Buffers[Slot].GetData(), Buffers[Slot].Num()))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("[BPDT] Write error in '%s'."), *Path);
+				return false;
+			}
+		}
+	}
+
+	if (Format == EBPDT_TextFormat::JSON)
+	{
+		const ANSICHAR* Footer = RowCount > 0 ? "\n]\n" : "]\n";
+		if (!File->Write((const uint8*)Footer, FCStringAnsi::Strlen(Footer)))
+		{
+			return false;
+		}
+	}
+
+	return File->Flush();
+}
@@ -0,0 +1,1003 @@
+#include "BPDT_WriteAheadLog.h"
+#include "BPDT_TableManager.h"
+#include "BPDT_FileManager.h"
+#include "BPDT_Snapshot.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Async/Async.h"
+
+static TAutoConsoleVariable<bool> CVarBPDTWALEnabled(
+	TEXT("BPDT.WAL.Enabled"),
+	true,
+	TEXT("Log table changes to a write-ahead log and replay it on startup. Read at startup."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarBPDTWALFlushInterval(
+	TEXT("BPDT.WAL.FlushInterval"),
+	0.05f,
+	TEXT("Seconds between group commits of the write-ahead log. Read at startup."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarBPDTWALCheckpointInterval(
+	TEXT("BPDT.WAL.CheckpointInterval"),
+	300.0f,
+	TEXT("Seconds between checkpoints (save all tables, drop the log). 0 disables."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarBPDTWALCheckpointMB(
+	TEXT("BPDT.WAL.CheckpointMB"),
+	64,
+	TEXT("Checkpoint once the current log segment reaches this many MB. 0 disables."),
+	ECVF_Default
+);
+
+// Record framing: uint32 payload bytes, uint32 CRC of the payload, payload
+static constexpr int32 BPDT_WAL_RECORD_HEADER_BYTES = 2 * sizeof(uint32);
+
+enum class EBPDT_WALRecord : uint8
+{
+	// Schema + every row; replaces the table
+	TableImage,
+	// (row index, row) pairs; an index equal to the row count appends
+	Rows,
+	Drop,
+	// Column changes (FBPDT_ColumnChange) in order; rows are not touched
+	Columns
+};
+
+/* ===================== SERIALIZATION ===================== */
+
+static void WriteCell(FArchive& Ar, const FBPDT_Cell& Cell)
+{
+	uint8 Type = (uint8)Cell.Type;
+	bool bIsNull = Cell.bIsNull;
+	int32 Size = Cell.Data.Num();
+
+	Ar << Type;
+	Ar << bIsNull;
+	Ar << Size;
+	Ar.Serialize(const_cast<uint8*>(Cell.Data.GetData()), Size);
+}
+
+static bool ReadCell(FArchive& Ar, FBPDT_Cell& OutCell)
+{
+	uint8 Type = 0;
+	int32 Size = 0;
+
+	Ar << Type;
+	Ar << OutCell.bIsNull;
+	Ar << Size;
+
+	if (Ar.IsError() || Size < 0 || Size > Ar.TotalSize() - Ar.Tell())
+	{
+		return false;
+	}
+
+	OutCell.Type = (EBPDT_CellType)Type;
+	OutCell.Data.SetNumUninitialized(Size);
+	Ar.Serialize(OutCell.Data.GetData(), Size);
+	return !Ar.IsError();
+}
+
+/* Every column, defaults included, so replay gets complete rows */
+static void WriteRow(FArchive& Ar, const FBPDT_Table& Table, int32 RowIndex)
+{
+	const FBPDT_Row& Row = Table.GetRowAt(RowIndex);
+
+	int32 CellCount = Table.GetColumns().Num();
+	Ar << CellCount;
+
+	for (int32 i = 0; i < CellCount; ++i)
+	{
+		WriteCell(Ar, Table.GetCell(Row, i));
+	}
+}
+
+static bool ReadRow(FArchive& Ar, FBPDT_Row& OutRow)
+{
+	int32 CellCount = 0;
+	Ar << CellCount;
+
+	if (Ar.IsError() || CellCount < 0 || CellCount > Ar.TotalSize() - Ar.Tell())
+	{
+		return false;
+	}
+
+	OutRow.Cells.SetNum(CellCount);
+	for (FBPDT_Cell& Cell : OutRow.Cells)
+	{
+		if (!ReadCell(Ar, Cell))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static void WriteColumn(FArchive& Ar, const FBPDT_Column& Column)
+{
+	FString Name = Column.Name.ToString();
+	uint8 Type = (uint8)Column.Type;
+	int32 ByteSize = Column.ByteSize;
+	TArray<uint8> DefaultData = Column.DefaultData;
+	bool bIsForeignKey = Column.bIsForeignKey;
+	FString ReferencedTable = Column.ReferencedTableName.ToString();
+
+	Ar << Name;
+	Ar << Type;
+	Ar << ByteSize;
+	Ar << DefaultData;
+	Ar << bIsForeignKey;
+	Ar << ReferencedTable;
+}
+
+static bool ReadColumn(FArchive& Ar, FBPDT_Column& OutColumn)
+{
+	FString Name;
+	uint8 Type = 0;
+	FString ReferencedTable;
+
+	Ar << Name;
+	Ar << Type;
+	Ar << OutColumn.ByteSize;
+	Ar << OutColumn.DefaultData;
+	Ar << OutColumn.bIsForeignKey;
+	Ar << ReferencedTable;
+
+	OutColumn.Name = FName(*Name);
+	OutColumn.Type = (EBPDT_CellType)Type;
+	OutColumn.ReferencedTableName = FName(*ReferencedTable);
+	return !Ar.IsError();
+}
+
+static void WriteColumnChange(FArchive& Ar, const FBPDT_ColumnChange& Change)
+{
+	uint8 Kind = (uint8)Change.Kind;
+	int32 ColumnIndex = Change.ColumnIndex;
+
+	FString NewName = Change.NewName.ToString();
+
+	Ar << Kind;
+	Ar << ColumnIndex;
+	WriteColumn(Ar, Change.Column);
+	Ar << NewName;
+}
+
+static bool ReadColumnChange(FArchive& Ar, FBPDT_ColumnChange& OutChange)
+{
+	uint8 Kind = 0;
+	Ar << Kind;
+	Ar << OutChange.ColumnIndex;
+
+	OutChange.Kind = (EBPDT_ColumnChange)Kind;
+	if (!ReadColumn(Ar, OutChange.Column))
+	{
+		return false;
+	}
+
+	FString NewName;
+	Ar << NewName;
+	OutChange.NewName = FName(*NewName);
+	return !Ar.IsError();
+}
+
+/* Through the table method that made the change; the column has to be where it was */
+static bool ApplyColumnChange(FBPDT_Table& Table, const FBPDT_ColumnChange& Change)
+{
+	const FBPDT_Column& Column = Change.Column;
+	const TArray<FBPDT_Column>& Columns = Table.GetColumns();
+
+	if (Change.Kind == EBPDT_ColumnChange::Add)
+	{
+		return Change.ColumnIndex == Columns.Num() &&
+			Table.AddColumn(Column.Name, Column.Type, Column.DefaultData.GetData(), Column.DefaultData.Num());
+	}
+
+	if (!Columns.IsValidIndex(Change.ColumnIndex) ||
+		Columns[Change.ColumnIndex].Name != Column.Name ||
+		Columns[Change.ColumnIndex].Type != Column.Type)
+	{
+		return false;
+	}
+
+	switch (Change.Kind)
+	{
+	case EBPDT_ColumnChange::Drop:
+		return Table.DropColumn(Column.Name);
+
+	case EBPDT_ColumnChange::Rename:
+		return Table.RenameColumn(Column.Name, Change.NewName);
+
+	default:
+		return false;
+	}
+}
+
+static void WriteHeader(FArchive& Ar, EBPDT_WALRecord Type, const FString& TableName)
+{
+	uint8 BinType = (uint8)Type;
+	FString Name = TableName;
+
+	Ar << BinType;
+	Ar << Name;
+}
+
+/* ===================== LIFETIME ===================== */
+
+FBPDT_WriteAheadLog& FBPDT_WriteAheadLog::Get()
+{
+	static FBPDT_WriteAheadLog Instance;
+	return Instance;
+}
+
+void FBPDT_WriteAheadLog::Startup()
+{
+	if (!CVarBPDTWALEnabled.GetValueOnAnyThread())
+	{
+		return;
+	}
+
+	TArray<int32> Segments;
+	FindSegments(Segments);
+
+	// ---- fold what the last session left into a checkpoint ----
+	if (Segments.Num() > 0)
+	{
+		if (Replay())
+		{
+			if (UBPDT_TableManager::SaveAllTables())
+			{
+				DeleteSegmentsUpTo(Segments.Last());
+			}
+			else
+			{
+				UE_LOG(LogTemp, Warning, TEXT("[BPDT] Checkpoint after log replay failed; keeping the log."));
+			}
+		}
+		else
+		{
+			// Nothing usable in them
+			DeleteSegmentsUpTo(Segments.Last());
+		}
+	}
+
+	// ---- what is in memory now is the base of the new log ----
+	TSharedRef<const FBPDT_DatabaseSnapshot> Snapshot = UBPDT_TableManager::TakeSnapshot();
+
+	FScopeLock FileLock(&FileMutex);
+	FScopeLock Lock(&Mutex);
+
+	Logged.Reset();
+	for (const auto& Pair : Snapshot->Tables)
+	{
+		FLoggedTable& Entry = Logged.Add(Pair.Key);
+		Entry.Version = Pair.Value.GetVersion();
+		Entry.SchemaVersion = Pair.Value.GetSchemaVersion();
+	}
+
+	if (!OpenSegment(Segments.Num() > 0 ? Segments.Last() + 1 : 0))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[BPDT] Could not open the write-ahead log; changes are not logged."));
+		return;
+	}
+
+	bOpen = true;
+	LastCheckpointTime = FPlatformTime::Seconds();
+
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateRaw(this, &FBPDT_WriteAheadLog::Tick),
+		FMath::Max(CVarBPDTWALFlushInterval.GetValueOnAnyThread(), 0.0f)
+	);
+}
+
+void FBPDT_WriteAheadLog::Shutdown()
+{
+	{
+		FScopeLock Lock(&Mutex);
+		if (!bOpen)
+		{
+			return;
+		}
+		bOpen = false;
+	}
+
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+	TickHandle.Reset();
+
+	FlushPending();
+
+	FScopeLock FileLock(&FileMutex);
+	File.Reset();
+}
+
+/* ===================== LOGGING ===================== */
+
+void FBPDT_WriteAheadLog::LogTables(const TArray<FString>& TableNames)
+{
+	FScopeLock Lock(&Mutex);
+
+	if (!bOpen || TableNames.Num() == 0)
+	{
+		return;
+	}
+
+	// Committed state, read in place under the log lock so records stay in
+	// change order; only the rows the tables recorded as changed are visited
+	UBPDT_TableManager::ForEachCommittedTable(TableNames, [this](const FString& TableName, FBPDT_Table* Table)
+	{
+		FLoggedTable* Entry = Logged.Find(TableName);
+
+		// Even without an entry: a table removed before it was ever loaded
+		// is still in the saved catalog
+		if (!Table)
+		{
+			AppendDrop(TableName);
+			Logged.Remove(TableName);
+			return;
+		}
+
+		if (Entry && Entry->Version == Table->GetVersion())
+		{
+			return;
+		}
+
+		TArray<int32> ChangedRows;
+		const bool bRowsTracked = Table->TakeChangedRows(ChangedRows);
+
+		TArray<FBPDT_ColumnChange> ColumnChanges;
+		const bool bColumnsTracked = Table->TakeColumnChanges(ColumnChanges);
+
+		// Changes from before the log's base are in the base already
+		if (Entry)
+		{
+			const uint64 Since = Entry->SchemaVersion;
+			ColumnChanges.RemoveAll([Since](const FBPDT_ColumnChange& Change)
+			{
+				return Change.SchemaVersion <= Since;
+			});
+		}
+
+		// Schema changes are logged as column changes when those cover them
+		const bool bSchemaLogged =
+			Entry &&
+			(Entry->SchemaVersion == Table->GetSchemaVersion() ||
+			(bColumnsTracked && ColumnChanges.Num() > 0 && ColumnChanges.Last().SchemaVersion == Table->GetSchemaVersion()));
+
+		// New, reloaded or otherwise restructured tables are logged whole
+		if (!bSchemaLogged)
+		{
+			AppendTableImage(TableName, *Table);
+		}
+		else
+		{
+			if (Entry->SchemaVersion != Table->GetSchemaVersion())
+			{
+				AppendColumnChanges(TableName, ColumnChanges);
+			}
+
+			if (!bRowsTracked)
+			{
+				CollectChangedGroups(*Table, Entry->Version, ChangedRows);
+			}
+			AppendChangedRows(TableName, *Table, ChangedRows);
+		}
+
+		FLoggedTable& Updated = Logged.FindOrAdd(TableName);
+		Updated.Version = Table->GetVersion();
+		Updated.SchemaVersion = Table->GetSchemaVersion();
+	});
+}
+
+void FBPDT_WriteAheadLog::NoteLoadedTable(const FString& TableName, uint64 Version, uint64 SchemaVersion)
+{
+	FScopeLock Lock(&Mutex);
+
+	if (!bOpen)
+	{
+		return;
+	}
+
+	// Versions only grow: a newer entry means the table was logged since
+	FLoggedTable& Entry = Logged.FindOrAdd(TableName);
+	if (Entry.Version < Version)
+	{
+		Entry.Version = Version;
+		Entry.SchemaVersion = SchemaVersion;
+	}
+}
+
+void FBPDT_WriteAheadLog::AppendTableImage(const FString& TableName, const FBPDT_Table& Table)
+{
+	TArray<uint8> Payload;
+	FMemoryWriter Ar(Payload);
+
+	WriteHeader(Ar, EBPDT_WALRecord::TableImage, TableName);
+
+	uint8 PKMode = (uint8)Table.PKMode;
+	FString PKColumnName = Table.GetPKColumnName().ToString();
+	int32 NextSerialID = Table.NextSerialID;
+	uint8 Compression = (uint8)Table.Compression;
+
+	Ar << PKMode;
+	Ar << PKColumnName;
+	Ar << NextSerialID;
+	Ar << Compression;
+
+	const TArray<FBPDT_Column>& Columns = Table.GetColumns();
+	int32 ColumnCount = Columns.Num();
+	Ar << ColumnCount;
+
+	for (const FBPDT_Column& Column : Columns)
+	{
+		WriteColumn(Ar, Column);
+	}
+
+	int32 RowCount = Table.GetRowCount();
+	Ar << RowCount;
+
+	for (int32 RowIndex = 0; RowIndex < RowCount; ++RowIndex)
+	{
+		WriteRow(Ar, Table, RowIndex);
+	}
+
+	AppendRecord(Payload);
+}
+
+void FBPDT_WriteAheadLog::CollectChangedGroups(
+	const FBPDT_Table& Table,
+	uint64 SinceVersion,
+	TArray<int32>& OutRows
+)
+{
+	const int32 RowCount = Table.GetRowCount();
+	const int32 GroupCount = (RowCount + BPDT_ROWS_PER_GROUP - 1) / BPDT_ROWS_PER_GROUP;
+
+	// Too many changes to track one by one; whole groups stamped since then
+	OutRows.Reset();
+	for (int32 Group = 0; Group < GroupCount; ++Group)
+	{
+		if (Table.GetRowGroupVersion(Group) <= SinceVersion)
+		{
+			continue;
+		}
+
+		const int32 Begin = Group * BPDT_ROWS_PER_GROUP;
+		const int32 End = FMath::Min(Begin + BPDT_ROWS_PER_GROUP, RowCount);
+
+		for (int32 RowIndex = Begin; RowIndex < End; ++RowIndex)
+		{
+			OutRows.Add(RowIndex);
+		}
+	}
+}
+
+void FBPDT_WriteAheadLog::AppendChangedRows(
+	const FString& TableName,
+	const FBPDT_Table& Table,
+	const TArray<int32>& Changed
+)
+{
+	if (Changed.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<uint8> Payload;
+	FMemoryWriter Ar(Payload);
+
+	WriteHeader(Ar, EBPDT_WALRecord::Rows, TableName);
+
+	int32 Count = Changed.Num();
+	Ar << Count;
+
+	for (int32 RowIndex : Changed)
+	{
+		Ar << RowIndex;
+		WriteRow(Ar, Table, RowIndex);
+	}
+
+	AppendRecord(Payload);
+}
+
+void FBPDT_WriteAheadLog::AppendColumnChanges(
+	const FString& TableName,
+	const TArray<FBPDT_ColumnChange>& Changes
+)
+{
+	TArray<uint8> Payload;
+	FMemoryWriter Ar(Payload);
+
+	WriteHeader(Ar, EBPDT_WALRecord::Columns, TableName);
+
+	int32 Count = Changes.Num();
+	Ar << Count;
+
+	for (const FBPDT_ColumnChange& Change : Changes)
+	{
+		WriteColumnChange(Ar, Change);
+	}
+
+	AppendRecord(Payload);
+}
+
+void FBPDT_WriteAheadLog::AppendDrop(const FString& TableName)
+{
+	TArray<uint8> Payload;
+	FMemoryWriter Ar(Payload);
+
+	WriteHeader(Ar, EBPDT_WALRecord::Drop, TableName);
+
+	AppendRecord(Payload);
+}
+
+void FBPDT_WriteAheadLog::AppendRecord(const TArray<uint8>& Payload)
+{
+	const uint32 Size = (uint32)Payload.Num();
+	const uint32 Crc = FCrc::MemCrc32(Payload.GetData(), Payload.Num());
+
+	Pending.Append(reinterpret_cast<const uint8*>(&Size), sizeof(uint32));
+	Pending.Append(reinterpret_cast<const uint8*>(&Crc), sizeof(uint32));
+	Pending.Append(Payload);
+
+	SegmentBytes += BPDT_WAL_RECORD_HEADER_BYTES + Payload.Num();
+}
+
+/* ===================== GROUP COMMIT / CHECKPOINTS ===================== */
+
+bool FBPDT_WriteAheadLog::Tick(float DeltaTime)
+{
+	bool bHasPending = false;
+	bool bCheckpointDue = false;
+	{
+		FScopeLock Lock(&Mutex);
+
+		bHasPending = Pending.Num() > 0;
+
+		const int64 MaxBytes = (int64)CVarBPDTWALCheckpointMB.GetValueOnGameThread() * 1024 * 1024;
+		const float Interval = CVarBPDTWALCheckpointInterval.GetValueOnGameThread();
+
+		bCheckpointDue =
+			SegmentBytes > 0 &&
+			((MaxBytes > 0 && SegmentBytes >= MaxBytes) ||
+			(Interval > 0.0f && FPlatformTime::Seconds() - LastCheckpointTime >= Interval));
+	}
+
+	if (bCheckpointDue)
+	{
+		Checkpoint();
+	}
+	else if (bHasPending && !bFlushInFlight.exchange(true))
+	{
+		// One batch in flight at a time; the next tick picks up what piles up meanwhile
+		Async(EAsyncExecution::ThreadPool, [this]()
+		{
+			FlushPending();
+			bFlushInFlight = false;
+		});
+	}
+
+	return true;
+}
+
+void FBPDT_WriteAheadLog::FlushPending()
+{
+	FScopeLock FileLock(&FileMutex);
+
+	TArray<uint8> Batch;
+	{
+		FScopeLock Lock(&Mutex);
+		Swap(Batch, Pending);
+	}
+
+	if (Batch.Num() == 0 || !File)
+	{
+		return;
+	}
+
+	if (!File->Write(Batch.GetData(), Batch.Num()) || !File->Flush(/*bFullFlush*/ true))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[BPDT] Write-ahead log write failed (%d bytes)."), Batch.Num());
+	}
+}
+
+void FBPDT_WriteAheadLog::Checkpoint()
+{
+	check(IsInGameThread());
+
+	if (bCheckpointInFlight.exchange(true))
+	{
+		return;
+	}
+
+	int32 CoveredSegment = INDEX_NONE;
+	TFuture<bool> Saved;
+	{
+		FScopeLock FileLock(&FileMutex);
+		FScopeLock Lock(&Mutex);
+
+		if (!bOpen)
+		{
+			bCheckpointInFlight = false;
+			return;
+		}
+
+		// Everything logged so far closes the current segment
+		if (Pending.Num() > 0 && File)
+		{
+			File->Write(Pending.GetData(), Pending.Num());
+			File->Flush(/*bFullFlush*/ true);
+		}
+		Pending.Reset();
+
+		CoveredSegment = SegmentIndex;
+		if (!OpenSegment(SegmentIndex + 1))
+		{
+			UE_LOG(LogTemp, Error, TEXT("[BPDT] Could not open a new write-ahead log segment."));
+			bOpen = false;
+			bCheckpointInFlight = false;
+			return;
+		}
+
+		// Snapshot taken under the log lock: it holds every change logged in
+		// the covered segments. Later changes go to the new segment.
+		Saved = UBPDT_TableManager::SaveAllTablesAsync();
+	}
+
+	LastCheckpointTime = FPlatformTime::Seconds();
+
+	Saved.Next([this, CoveredSegment](bool bSaved)
+	{
+		if (bSaved)
+		{
+			DeleteSegmentsUpTo(CoveredSegment);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[BPDT] Checkpoint save failed; keeping the log."));
+		}
+
+		bCheckpointInFlight = false;
+	});
+}
+
+/* ===================== REPLAY ===================== */
+
+bool FBPDT_WriteAheadLog::Replay()
+{
+	// Records go through the table methods that made the changes, on copies
+	// of the loaded tables (O(columns) each) installed once at the end
+	TSharedRef<const FBPDT_DatabaseSnapshot> Base = UBPDT_TableManager::TakeSnapshot();
+
+	TMap<FString, FBPDT_Table> Touched;
+	TSet<FString> Dropped;
+	int32 Applied = 0;
+
+	auto Touch = [&](const FString& TableName) -> FBPDT_Table*
+	{
+		if (FBPDT_Table* Existing = Touched.Find(TableName))
+		{
+			return Existing;
+		}
+
+		if (Dropped.Contains(TableName))
+		{
+			return nullptr;
+		}
+
+		// Lazy mode: the table may not have been loaded when Base was taken
+		TSharedPtr<const FBPDT_DatabaseSnapshot> Loaded;
+		const FBPDT_Table* Table = Base->FindTable(TableName);
+		if (!Table)
+		{
+			Loaded = UBPDT_TableManager::TakeSnapshot({ TableName });
+			Table = Loaded->FindTable(TableName);
+		}
+		if (!Table)
+		{
+			return nullptr;
+		}
+
+		return &Touched.Add(TableName, Table->MakeSnapshot());
+	};
+
+	TArray<int32> Segments;
+	FindSegments(Segments);
+
+	bool bTornTail = false;
+
+	for (int32 Segment : Segments)
+	{
+		TArray<uint8> Bytes;
+		if (!FFileHelper::LoadFileToArray(Bytes, *GetSegmentPath(Segment)))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[BPDT] Could not read log segment %d."), Segment);
+			break;
+		}
+
+		int64 Offset = 0;
+		while (Offset + BPDT_WAL_RECORD_HEADER_BYTES <= Bytes.Num())
+		{
+			uint32 Size = 0;
+			uint32 Crc = 0;
+			FMemory::Memcpy(&Size, &Bytes[Offset], sizeof(uint32));
+			FMemory::Memcpy(&Crc, &Bytes[Offset + sizeof(uint32)], sizeof(uint32));
+
+			const uint8* Payload = Bytes.GetData() + Offset + BPDT_WAL_RECORD_HEADER_BYTES;
+
+			// A record cut short by the crash ends the log
+			if (Offset + BPDT_WAL_RECORD_HEADER_BYTES + Size > Bytes.Num() ||
+				FCrc::MemCrc32(Payload, Size) != Crc)
+			{
+				bTornTail = true;
+				break;
+			}
+
+			Offset += BPDT_WAL_RECORD_HEADER_BYTES + Size;
+
+			FMemoryReaderView Ar(TArrayView<const uint8>(Payload, Size));
+
+			uint8 Type = 0;
+			FString TableName;
+			Ar << Type;
+			Ar << TableName;
+
+			// A record that reads fine but does not fit its table stops the
+			// replay just like a damaged one: what follows builds on it
+			bool bApplied = true;
+
+			switch ((EBPDT_WALRecord)Type)
+			{
+			case EBPDT_WALRecord::TableImage:
+			{
+				uint8 PKMode = 0;
+				FString PKColumnName;
+				int32 NextSerialID = 1;
+				uint8 Compression = 0;
+				int32 ColumnCount = 0;
+				Ar << PKMode;
+				Ar << PKColumnName;
+				Ar << NextSerialID;
+				Ar << Compression;
+				Ar << ColumnCount;
+
+				TArray<FBPDT_Column> Columns;
+				for (int32 i = 0; i < ColumnCount && !Ar.IsError(); ++i)
+				{
+					ReadColumn(Ar, Columns.AddDefaulted_GetRef());
+				}
+
+				int32 RowCount = 0;
+				Ar << RowCount;
+
+				TArray<FBPDT_Row> Rows;
+				bool bRowsOk = !Ar.IsError() && RowCount >= 0;
+				for (int32 i = 0; i < RowCount && bRowsOk; ++i)
+				{
+					bRowsOk = ReadRow(Ar, Rows.AddDefaulted_GetRef());
+				}
+
+				if (!bRowsOk)
+				{
+					bTornTail = true;
+					break;
+				}
+
+				FBPDT_Table Image;
+				Image.InitSchema((EBPDT_PrimaryKeyMode)PKMode, FName(*PKColumnName), Columns, NextSerialID);
+				Image.Compression = (EBPDT_Compression)Compression;
+
+				bApplied = Image.AppendRows(MoveTemp(Rows));
+				if (bApplied)
+				{
+					Touched.Add(TableName, MoveTemp(Image));
+					Dropped.Remove(TableName);
+					++Applied;
+				}
+				break;
+			}
+
+			case EBPDT_WALRecord::Rows:
+			{
+				FBPDT_Table* Table = Touch(TableName);
+
+				int32 Count = 0;
+				Ar << Count;
+
+				if (!Table)
+				{
+					UE_LOG(LogTemp, Warning, TEXT("[BPDT] Log has rows for unknown table '%s'; skipped."), *TableName);
+					break;
+				}
+
+				// Rows come in index order; those past the end are appended in one go
+				TArray<FBPDT_Row> Appended;
+
+				bool bRowsOk = !Ar.IsError();
+				for (int32 i = 0; i < Count && bRowsOk && bApplied; ++i)
+				{
+					int32 RowIndex = INDEX_NONE;
+					FBPDT_Row Row;
+					Ar << RowIndex;
+
+					bRowsOk = ReadRow(Ar, Row);
+					if (!bRowsOk)
+					{
+						break;
+					}
+
+					if (RowIndex == Table->GetRowCount() + Appended.Num())
+					{
+						Appended.Add(MoveTemp(Row));
+					}
+					else
+					{
+						bApplied = Appended.Num() == 0 && Table->ReplaceRowAt(RowIndex, MoveTemp(Row));
+					}
+				}
+
+				if (!bRowsOk)
+				{
+					bTornTail = true;
+					break;
+				}
+
+				bApplied = bApplied && (Appended.Num() == 0 || Table->AppendRows(MoveTemp(Appended)));
+				if (bApplied)
+				{
+					++Applied;
+				}
+				break;
+			}
+
+			case EBPDT_WALRecord::Columns:
+			{
+				FBPDT_Table* Table = Touch(TableName);
+
+				int32 Count = 0;
+				Ar << Count;
+
+				if (!Table)
+				{
+					UE_LOG(LogTemp, Warning, TEXT("[BPDT] Log has column changes for unknown table '%s'; skipped."), *TableName);
+					break;
+				}
+
+				bool bChangesOk = !Ar.IsError();
+				for (int32 i = 0; i < Count && bChangesOk && bApplied; ++i)
+				{
+					FBPDT_ColumnChange Change;
+					bChangesOk = ReadColumnChange(Ar, Change);
+					bApplied = bChangesOk && ApplyColumnChange(*Table, Change);
+				}
+
+				if (!bChangesOk)
+				{
+					bTornTail = true;
+					break;
+				}
+
+				if (bApplied)
+				{
+					++Applied;
+				}
+				break;
+			}
+
+			case EBPDT_WALRecord::Drop:
+				Touched.Remove(TableName);
+				Dropped.Add(TableName);
+				++Applied;
+				break;
+
+			default:
+				bTornTail = true;
+				break;
+			}
+
+			if (!bApplied)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("[BPDT] Log record for '%s' does not fit the table; replay stops there."), *TableName);
+				bTornTail = true;
+			}
+
+			if (bTornTail)
+			{
+				break;
+			}
+		}
+
+		if (bTornTail)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[BPDT] Log segment %d ends in a damaged record; replay stops there."), Segment);
+			break;
+		}
+	}
+
+	if (Applied == 0)
+	{
+		return false;
+	}
+
+	// ---- install ----
+	// Loaded or not; the next checkpoint takes them out of the catalog
+	for (const FString& TableName : Dropped)
+	{
+		UBPDT_TableManager::RemoveTable(TableName);
+	}
+
+	UBPDT_TableManager::InstallTables(MoveTemp(Touched));
+
+	UE_LOG(LogTemp, Log, TEXT("[BPDT] Replayed %d log records from %d segments."), Applied, Segments.Num());
+	return true;
+}
+
+/* ===================== SEGMENTS ===================== */
+
+FString FBPDT_WriteAheadLog::GetSegmentPath(int32 Index)
+{
+	return FBPDT_FileManager::GetSaveDirectory() /
+		FString::Printf(TEXT("__BPDT_WAL_%08d.log"), Index);
+}
+
+void FBPDT_WriteAheadLog::FindSegments(TArray<int32>& OutIndices)
+{
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(
+		Files,
+		*(FBPDT_FileManager::GetSaveDirectory() / TEXT("__BPDT_WAL_*.log")),
+		true,
+		false
+	);
+
+	OutIndices.Reset();
+	for (const FString& FileName : Files)
+	{
+		const FString Number = FPaths::GetBaseFilename(FileName).RightChop(11);
+		if (Number.IsNumeric())
+		{
+			OutIndices.Add(FCString::Atoi(*Number));
+		}
+	}
+
+	OutIndices.Sort();
+}
+
+void FBPDT_WriteAheadLog::DeleteSegmentsUpTo(int32 LastIndex)
+{
+	TArray<int32> Segments;
+	FindSegments(Segments);
+
+	for (int32 Segment : Segments)
+	{
+		if (Segment <= LastIndex)
+		{
+			IFileManager::Get().Delete(*GetSegmentPath(Segment));
+		}
+	}
+}
+
+bool FBPDT_WriteAheadLog::OpenSegment(int32 Index)
+{
+	IPlatformFile& PF =
+		FPlatformFileManager::Get().GetPlatformFile();
+
+	const FString Directory = FBPDT_FileManager::GetSaveDirectory();
+	if (!PF.DirectoryExists(*Directory))
+	{
+		PF.CreateDirectoryTree(*Directory);
+	}
+
+	File.Reset(PF.OpenWrite(*GetSegmentPath(Index)));
+	SegmentIndex = Index;
+	SegmentBytes = 0;
+
+	return File.IsValid();
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "Async/Future.h"
+#include "BPDT_AsyncTableIO.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FBPDT_AsyncTableIOCompleted, bool, bSuccess);
+
+/**
+ * Latent Blueprint nodes for the async save/load API of UBPDT_TableManager.
+ * The output pin fires on the game thread once the operation has finished;
+ * for loads the tables are already installed at that point.
+ */
+UCLASS()
+class BPDT_RUNTIME_API UBPDT_AsyncTableIO : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintAssignable)
+	FBPDT_AsyncTableIOCompleted OnCompleted;
+
+	UFUNCTION(BlueprintCallable, Category = "BPDT|Save", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UBPDT_AsyncTableIO* SaveTableAsync(UObject* WorldContextObject, const FString& TableName);
+
+	UFUNCTION(BlueprintCallable, Category = "BPDT|Save", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UBPDT_AsyncTableIO* SaveAllTablesAsync(UObject* WorldContextObject);
+
+	UFUNCTION(BlueprintCallable, Category = "BPDT|Load", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UBPDT_AsyncTableIO* LoadTableAsync(UObject* WorldContextObject, const FString& TableName);
+
+	UFUNCTION(BlueprintCallable, Category = "BPDT|Load", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UBPDT_AsyncTableIO* LoadAllTablesAsync(UObject* WorldContextObject);
+
+	virtual void Activate() override;
+
+private:
+	enum class EOperation : uint8
+	{
+		SaveTable,
+		SaveAllTables,
+		LoadTable,
+		LoadAllTables
+	};
+
+	static UBPDT_AsyncTableIO* Create(
+		UObject* WorldContextObject,
+		EOperation Operation,
+		const FString& TableName
+	);
+
+	void Finish(bool bSuccess);
+
+	EOperation Operation = EOperation::SaveAllTables;
+	FString TableName;
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BPDT_Types.h"
+#include "BPDT_BufferPool.generated.h"
+
+USTRUCT(BlueprintType)
+struct FBPDT_BufferPoolStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	int64 CapacityBytes = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int64 UsedBytes = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 Pages = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int64 Hits = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int64 Misses = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int64 Evictions = 0;
+
+	// Hits / (Hits + Misses); 0 before the first lookup
+	UPROPERTY(BlueprintReadOnly)
+	float HitRate = 0.0f;
+};
+
+/** Decoded cells of one column over one row group of a saved data file */
+using FBPDT_Page = TArray<FBPDT_Cell>;
+using FBPDT_PageRef = TSharedPtr<const FBPDT_Page, ESPMode::ThreadSafe>;
+
+/* A page is only valid for the exact committed file it was read from */
+struct FBPDT_PageKey
+{
+	FString DataFile;
+	int64 DataBytes = 0;
+	int32 Column = 0;
+	int32 Group = 0;
+
+	bool operator==(const FBPDT_PageKey& Other) const
+	{
+		return DataBytes == Other.DataBytes
+			&& Column == Other.Column
+			&& Group == Other.Group
+			&& DataFile == Other.DataFile;
+	}
+
+	friend uint32 GetTypeHash(const FBPDT_PageKey& Key)
+	{
+		return HashCombine(
+			HashCombine(GetTypeHash(Key.DataFile), GetTypeHash(Key.DataBytes)),
+			HashCombine(GetTypeHash(Key.Column), GetTypeHash(Key.Group))
+		);
+	}
+};
+
+/**
+ * Bounded cache of pages of saved tables, used to read tables that lazy
+ * loading keeps on disk without loading them (BPDT.BufferPoolMB, 0 = off).
+ *
+ * Eviction is CLOCK: a hit sets the page's reference bit; to make room the
+ * hand sweeps the frames, clearing set bits and evicting the first page
+ * whose bit is already clear. Pages handed out stay valid after eviction.
+ */
+class BPDT_RUNTIME_API FBPDT_BufferPool
+{
+public:
+	static FBPDT_BufferPool& Get();
+
+	bool IsEnabled() const;
+
+	/* Null on a miss */
+	FBPDT_PageRef Find(const FBPDT_PageKey& Key);
+
+	/* Caches the page if it fits the budget; returns the cached copy when another thread won */
+	FBPDT_PageRef Add(const FBPDT_PageKey& Key, FBPDT_Page&& Page);
+
+	void Reset();
+
+	FBPDT_BufferPoolStats GetStats() const;
+
+private:
+	FBPDT_BufferPool() = default;
+
+	struct FFrame
+	{
+		FBPDT_PageKey Key;
+		FBPDT_PageRef Page;
+		int64 Bytes = 0;
+		bool bReferenced = false;
+	};
+
+	/* Caller holds Mutex */
+	void EvictUntilFits(int64 Bytes, int64 Capacity);
+
+	static int64 GetCapacityBytes();
+
+	mutable FCriticalSection Mutex;
+
+	// Clock ring; empty frames (null Page) are reused through FreeFrames
+	TArray<FFrame> Frames;
+	TArray<int32> FreeFrames;
+	TMap<FBPDT_PageKey, int32> FrameIndex;
+	int32 Hand = 0;
+
+	int64 UsedBytes = 0;
+	int64 Hits = 0;
+	int64 Misses = 0;
+	int64 Evictions = 0;
+};
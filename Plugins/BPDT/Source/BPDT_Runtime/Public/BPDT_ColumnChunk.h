@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BPDT_Types.h"
+
+/** Value encoding of one column chunk (data file v2) */
+enum class EBPDT_ChunkEncoding : uint8
+{
+	// Fixed-width values back to back
+	Plain,
+	// Bools, one bit per value
+	BitPacked,
+	// Ints as (value - min), packed to the smallest bit width
+	FrameOfReference,
+	// Ints as first value + (delta - min delta) packed; serial keys pack to 0 bits
+	Delta,
+	// Never written; keeps the numbers of the encodings after it
+	Dictionary,
+	// Fixed-width values as (run length, value) pairs
+	RunLength,
+	// Strings as a string heap: packed end offsets + one contiguous UTF-8 blob
+	StringHeap,
+	// Strings as a dictionary stored as a string heap + packed indices
+	HeapDictionary
+};
+
+/**
+ * Header in front of every chunk. Followed by PayloadBytes bytes:
+ * the null bitmap (only when NullCount > 0, bit set = null) and the
+ * encoded non-null values.
+ */
+struct FBPDT_ChunkHeader
+{
+	uint8 Encoding = 0;
+	uint8 CellType = 0;
+	uint16 Reserved = 0;
+	uint32 RowCount = 0;
+	uint32 NullCount = 0;
+	uint32 PayloadBytes = 0;
+};
+
+static_assert(sizeof(FBPDT_ChunkHeader) == 16, "FBPDT_ChunkHeader is part of the file format");
+
+/**
+ * Encoder/decoder for the cells of one column over a range of rows.
+ * The encoder tries every encoding valid for the cell type and keeps the
+ * smallest one.
+ */
+class BPDT_RUNTIME_API FBPDT_ColumnChunk
+{
+public:
+	/* Appends one chunk (header + bitmap + payload) for cells [0, RowCount) */
+	static void Encode(
+		EBPDT_CellType Type,
+		int32 ByteSize,
+		int32 RowCount,
+		TFunctionRef<const FBPDT_Cell& (int32 RowInChunk)> GetCell,
+		TArray<uint8>& Out
+	);
+
+	/**
+	 * Decodes one chunk starting at Data. Emit is called once per row, in
+	 * order. Returns false on malformed or mismatching data.
+	 */
+	static bool Decode(
+		const uint8* Data,
+		int64 Size,
+		EBPDT_CellType Type,
+		int32 ByteSize,
+		TFunctionRef<void(int32 RowInChunk, FBPDT_Cell&& Cell)> Emit
+	);
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "BPDT_Types.h"
+
+#include <atomic>
+
+#include "BPDT_CommandBuffer.generated.h"
+
+struct FBPDT_Table;
+
+/** Where in the frame queued table mutations are applied */
+UENUM(BlueprintType)
+enum class EBPDT_CommandFlushPoint : uint8
+{
+	BeginFrame,
+	EndFrame,
+	// Only when FlushCommandBuffer is called
+	Manual
+};
+
+enum class EBPDT_CommandType : uint8
+{
+	SetCell,
+	InsertRow,
+	ChangePrimaryKey
+};
+
+struct FBPDT_Command
+{
+	EBPDT_CommandType Type = EBPDT_CommandType::SetCell;
+
+	// Global enqueue order
+	uint64 Sequence = 0;
+
+	FString TableName;
+
+	// SetCell: target row. ChangePrimaryKey: old PK.
+	FString PKValue;
+
+	// ChangePrimaryKey only
+	FString NewPKValue;
+
+	// SetCell only
+	FName ColumnName;
+	FBPDT_Cell Cell;
+
+	// InsertRow only: one cell per column, PK cell ignored on serial tables
+	TArray<FBPDT_Cell> RowCells;
+};
+
+/**
+ * Deferred table mutations.
+ *
+ * Any thread may enqueue without touching the table map (the queue is a
+ * lock-free multi-producer queue). The game thread applies everything in one
+ * pass at the configured flush point:
+ *  - commands are grouped per table, each group runs under one write scope
+ *  - repeated SetCell writes to the same cell are coalesced (last one wins)
+ *  - surviving writes are applied sorted by column, then row position
+ *  - InsertRow and ChangePrimaryKey act as barriers, so per-table order is kept
+ * There is no ordering guarantee between commands of different tables.
+ */
+class BPDT_RUNTIME_API FBPDT_CommandBuffer
+{
+public:
+	static FBPDT_CommandBuffer& Get();
+
+	/* ---------- Producers (any thread) ---------- */
+
+	void EnqueueSetCell(
+		const FString& TableName,
+		const FString& PKValue,
+		FName ColumnName,
+		const FBPDT_Cell& Cell
+	);
+
+	void EnqueueInsertRow(
+		const FString& TableName,
+		TArray<FBPDT_Cell> Cells
+	);
+
+	void EnqueueChangePrimaryKey(
+		const FString& TableName,
+		const FString& OldPKValue,
+		const FString& NewPKValue
+	);
+
+	/* ---------- Game thread ---------- */
+
+	/* Applies every queued command; returns how many took effect */
+	int32 Flush();
+
+	void SetFlushPoint(EBPDT_CommandFlushPoint NewFlushPoint);
+	EBPDT_CommandFlushPoint GetFlushPoint() const { return FlushPoint; }
+
+	void Startup();
+	void Shutdown();
+
+private:
+	FBPDT_CommandBuffer() = default;
+
+	void Enqueue(FBPDT_Command&& Command);
+
+	void HookFrameDelegate();
+	void UnhookFrameDelegate();
+	void OnFrameBoundary();
+
+	int32 ApplyTableCommands(
+		const FString& TableName,
+		TArray<FBPDT_Command>& Commands,
+		TArrayView<const int32> Indices
+	);
+
+	int32 ApplySetCellBatch(
+		FBPDT_Table& Table,
+		TArray<FBPDT_Command>& Commands,
+		TArrayView<const int32> Indices
+	);
+
+	bool ApplyInsertRow(FBPDT_Table& Table, FBPDT_Command& Command);
+
+	TQueue<FBPDT_Command, EQueueMode::Mpsc> Queue;
+	std::atomic<uint64> NextSequence{ 0 };
+
+	EBPDT_CommandFlushPoint FlushPoint = EBPDT_CommandFlushPoint::EndFrame;
+	FDelegateHandle FrameHandle;
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BPDT_Table.h"
+#include "BPDT_ForeignKeyConstraint.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Read-only tables cooked into a packaged build (Content/BPDT/Cooked,
+ * written by the BPDT_CookTables commandlet and staged with the content).
+ *
+ * The file is mapped and read in place, with no decoding step: every column
+ * is a fixed-width array over the rows plus an optional null bitmap, strings
+ * are ids into one interned pool, and each table carries its row positions
+ * sorted by PK for binary-search lookups.
+ *
+ * Packaged builds seed the catalog from it (see FBPDT_FileManager): a cooked
+ * table is read from the mapping until its first save, after which it lives
+ * in Saved/ like any other table.
+ */
+class BPDT_RUNTIME_API FBPDT_CookedTables
+{
+public:
+	static FBPDT_CookedTables& Get();
+
+	/* Maps the cooked file when the build requires cooked data and has one */
+	bool Mount();
+	void Unmount();
+
+	bool IsMounted() const { return Data != nullptr; }
+
+	void GetTableNames(TArray<FString>& OutTableNames) const;
+	void GetForeignKeys(TArray<FBPDT_ForeignKeyConstraint>& OutForeignKeys) const;
+
+	/* False if the cook has no such table */
+	bool ReadSchema(
+		const FString& TableName,
+		EBPDT_PrimaryKeyMode& OutPKMode,
+		FName& OutPKColumnName,
+		TArray<FBPDT_Column>& OutColumns,
+		int32& OutNextSerialID,
+		int32& OutRowCount
+	) const;
+
+	/* Cells of rows [Begin, End) of one column */
+	bool ReadCells(
+		const FString& TableName,
+		int32 ColumnIndex,
+		int32 Begin,
+		int32 End,
+		TArray<FBPDT_Cell>& OutCells
+	) const;
+
+	/* Row position of the PK as GetAllRowPKValues prints it; INDEX_NONE when absent */
+	bool FindRow(const FString& TableName, const FString& PKValue, int32& OutRowIndex) const;
+
+	static FString GetCookedPath();
+
+#if WITH_EDITOR
+	static bool Write(
+		const FString& Path,
+		const TMap<FString, FBPDT_Table>& Tables,
+		const TArray<FBPDT_ForeignKeyConstraint>& ForeignKeys
+	);
+#endif
+
+private:
+	FBPDT_CookedTables() = default;
+	~FBPDT_CookedTables();
+
+	struct FCookedTable;
+	struct FCookedColumn;
+
+	const FCookedTable* FindTable(const FString& TableName) const;
+	const FCookedColumn* GetColumns(const FCookedTable& Table) const;
+
+	/* Bytes of a pool string */
+	bool GetString(uint32 Id, const uint8*& OutBytes, int32& OutLen) const;
+	FString GetStringAsText(uint32 Id) const;
+
+	bool Validate();
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	// The file read into memory when it cannot be mapped (e.g. a compressed pak)
+	TArray64<uint8> Contents;
+
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+
+	// Table name -> directory index, built at mount
+	TMap<FString, int32> TableIndex;
+};
@@ -2,40 +2,180 @@
 
 #include "CoreMinimal.h"
 #include "BPDT_Table.h"
+#include "BPDT_ForeignKeyConstraint.h"
+#include "BPDT_BufferPool.h"
 
 class BPDT_RUNTIME_API FBPDT_FileManager
 {
 public:
+	/**
+	 * Saves the tables, plus the FK constraints when given, as one unit:
+	 * changed data files are written under new names and a new catalog
+	 * version (schemas, FKs, file lengths and checksums) then publishes them
+	 * all at once. A crash before that leaves the previous save intact. Clean
+	 * tables are skipped; changed rows are appended to the current data file
+	 * when the schema did not change. RemovedTables leave the catalog in the
+	 * same version, and their files with the previous one.
+	 */
+	static bool WriteTables(
+		const TMap<FString, FBPDT_Table>& Tables,
+		const TArray<FBPDT_ForeignKeyConstraint>* ForeignKeys,
+		const TSet<FString>* RemovedTables = nullptr
+	);
+
 	static bool WriteTable(
 		const FString& TableName,
 		const FBPDT_Table& Table
 	);
+
+	static bool WriteForeignKeys(const TArray<FBPDT_ForeignKeyConstraint>& ForeignKeys);
+
+	/* Empty when no constraints were saved */
+	static bool ReadForeignKeys(TArray<FBPDT_ForeignKeyConstraint>& OutForeignKeys);
+
+	/* Whether the table's saved rows are still its cooked ones (BPDT_CookedTables.h) */
+	static bool IsTableCooked(const FString& TableName);
+
+	/* Cooked tables only: row position by PK through the cooked PK order, INDEX_NONE if absent */
+	static bool FindCookedRow(const FString& TableName, const FString& PKValue, int32& OutRowIndex);
+
+	/* Whether the published files hold exactly this version of the table */
+	static bool IsTableSaved(const FString& TableName, uint64 Version);
+
+	/* A metadata-only change took the table from FilesVersion to NewVersion */
+	static void NoteTableUnchanged(const FString& TableName, uint64 FilesVersion, uint64 NewVersion);
+
 	static bool ReadTable(
 		const FString& TableName,
 		FBPDT_Table& OutTable
 	);
 
+	/* One column of a saved table, in row order, without loading the rest */
+	static bool ReadColumn(
+		const FString& TableName,
+		FName ColumnName,
+		TArray<FBPDT_Cell>& OutCells
+	);
+
+	/* Schema of a saved table as the catalog has it, without touching the data file */
+	static bool ReadSavedSchema(
+		const FString& TableName,
+		TArray<FBPDT_Column>& OutColumns,
+		FName& OutPKColumnName,
+		int32& OutRowCount
+	);
+
+	/**
+	 * One column over one row group (BPDT_ROWS_PER_GROUP rows) of a saved
+	 * table, through the buffer pool; cooked tables straight from the cook.
+	 * False for files without row groups (v1) and for migrated tables not
+	 * read yet.
+	 */
+	static bool ReadColumnPage(
+		const FString& TableName,
+		int32 ColumnIndex,
+		int32 Group,
+		FBPDT_PageRef& OutPage
+	);
+
+	/**
+	 * ReadColumnPage over groups [FirstGroup, FirstGroup + NumGroups), handed
+	 * to Use in order. Pages the pool misses are read ahead of their decode
+	 * (BPDT.Prefetch.Depth); Use returning false stops with false.
+	 */
+	static bool ReadColumnPages(
+		const FString& TableName,
+		int32 ColumnIndex,
+		int32 FirstGroup,
+		int32 NumGroups,
+		TFunctionRef<bool(int32 Group, const FBPDT_PageRef& Page)> Use
+	);
+
+	/* Tables of the published catalog (migrated from the text layout on first use) */
 	static bool IsTableInRegistry(const FString& TableName);
 	static bool ReadRegistry(TArray<FString>& OutTableNames);
-private:
+
+	/* Saved/Plugins/BPDT: catalog, data files, write-ahead log */
 	static FString GetSaveDirectory();
-	static bool AddTableToRegistry(const FString& TableName);
-	static FString GetRegistryPath();
+private:
+	static void EncodeDataFile(
+		const FBPDT_Table& Table,
+		TArray<uint8>& Out
+	);
 
-	static bool WriteSchemeFile(
+	/**
+	 * Appends the row groups changed after SavedVersion plus a new footer
+	 * past the SavedBytes committed bytes; OutBytes is the new length and
+	 * InOutCrc goes from the CRC of the committed bytes to that of the file.
+	 * Returns false when the file cannot be patched (layout mismatch) or is
+	 * due for compaction; the caller then rewrites it whole.
+	 */
+	static bool AppendDirtyRowGroups(
 		const FString& Path,
-		const FString& TableName,
-		const FBPDT_Table& Table
+		const FBPDT_Table& Table,
+		uint64 SavedVersion,
+		int32 SavedRowCount,
+		int64 SavedBytes,
+		int64& OutBytes,
+		uint32& InOutCrc
+	);
+
+	static void EncodeRowGroups(
+		const FBPDT_Table& Table,
+		const TArray<int32>& Groups,
+		TArray<TArray<uint8>>& OutChunks
 	);
 
-	static bool WriteDataFile(
+	/* Memory-maps the first Bytes bytes (-1 = all) for the duration of Use */
+	static bool MapFile(
 		const FString& Path,
-		const FBPDT_Table& Table
+		int64 Bytes,
+		TFunctionRef<bool(const uint8* Data, int64 Size)> Use
+	);
+
+	/**
+	 * Loads a v2/v3 file through async reads, decoding each row group as
+	 * soon as its chunks are in while the next reads are in flight. OutCrc
+	 * covers the first OutSize bytes. bOutStreamed is false when the file
+	 * was left untouched (v1, cannot be opened) for the caller to read whole.
+	 */
+	static bool StreamDataFile(
+		const FString& Path,
+		int64 Bytes,
+		const TArray<FBPDT_Column>& Columns,
+		int32 RowCount,
+		TArray<FBPDT_Row>& OutRows,
+		int64& OutSize,
+		uint32& OutCrc,
+		bool& bOutStreamed
+	);
+
+	/* OnlyColumn != INDEX_NONE: rows hold just that cell where the format allows it */
+	static bool DecodeDataFile(
+		const uint8* Data,
+		int64 Size,
+		const TArray<FBPDT_Column>& Columns,
+		int32 RowCount,
+		int32 OnlyColumn,
+		TArray<FBPDT_Row>& OutRows
+	);
+
+	static bool DecodeRowsV1(
+		const uint8* Data,
+		int64 Size,
+		const TArray<FBPDT_Column>& Columns,
+		int32 RowCount,
+		TArray<FBPDT_Row>& OutRows
 	);
 
-	static void WriteNullMask(
-		FArchive& Ar,
-		const FBPDT_Row& Row,
-		int32 ColumnCount
+	/* bBlocks: v3, each chunk is wrapped in a (possibly compressed) block */
+	static bool DecodeColumnsV2(
+		const uint8* Data,
+		int64 Size,
+		const TArray<FBPDT_Column>& Columns,
+		int32 RowCount,
+		int32 OnlyColumn,
+		bool bBlocks,
+		TArray<FBPDT_Row>& OutRows
 	);
 };
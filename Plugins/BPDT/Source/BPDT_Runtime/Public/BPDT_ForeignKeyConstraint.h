@@ -19,4 +19,12 @@ struct FBPDT_ForeignKeyConstraint
 
 	UPROPERTY()
 	FName PKColumn;
+
+	bool operator==(const FBPDT_ForeignKeyConstraint& Other) const
+	{
+		return FKTable == Other.FKTable
+			&& FKColumn == Other.FKColumn
+			&& PKTable == Other.PKTable
+			&& PKColumn == Other.PKColumn;
+	}
 };
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IAsyncReadFileHandle;
+class IAsyncReadRequest;
+
+/**
+ * Reads ahead in a table data file through IAsyncReadFileHandle.
+ *
+ * Reads are queued with Prefetch and collected in the same order with Next,
+ * so a caller can keep BPDT.Prefetch.Depth reads in flight while it decodes
+ * what already arrived. Stream does that for one contiguous range.
+ *
+ * Not thread safe; one reader per load. The file stays open until the
+ * reader is destroyed, which waits for any read still in flight.
+ */
+class BPDT_RUNTIME_API FBPDT_PrefetchReader
+{
+public:
+	explicit FBPDT_PrefetchReader(const FString& Path);
+	~FBPDT_PrefetchReader();
+
+	FBPDT_PrefetchReader(const FBPDT_PrefetchReader&) = delete;
+	FBPDT_PrefetchReader& operator=(const FBPDT_PrefetchReader&) = delete;
+
+	bool IsOpen() const { return Handle.IsValid(); }
+
+	/* Reads in flight at once (2 = double buffering) and bytes per streamed read */
+	static int32 GetDepth();
+	static int64 GetBlockBytes();
+
+	/* Queues a read of [Offset, Offset + Bytes) */
+	void Prefetch(int64 Offset, int64 Bytes);
+
+	/* Waits for the oldest queued read and copies its bytes to Dest; false if it failed */
+	bool Next(uint8* Dest);
+
+	int32 NumPending() const { return Pending.Num(); }
+
+	/* Prefetch + Next; nothing else may be queued */
+	bool Read(int64 Offset, int64 Bytes, uint8* Dest);
+
+	/**
+	 * Reads [Begin, End) into Dest (which holds that range) in blocks,
+	 * in order. OnReady gets the end of what has arrived after each block
+	 * while the next ones are already being read; returning false stops.
+	 */
+	bool Stream(
+		int64 Begin,
+		int64 End,
+		uint8* Dest,
+		TFunctionRef<bool(int64 ReadyEnd)> OnReady
+	);
+
+private:
+	struct FPendingRead
+	{
+		IAsyncReadRequest* Request = nullptr;
+		int64 Bytes = 0;
+	};
+
+	TUniquePtr<IAsyncReadFileHandle> Handle;
+	TArray<FPendingRead> Pending;
+};
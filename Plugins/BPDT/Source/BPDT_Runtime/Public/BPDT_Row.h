@@ -10,6 +10,10 @@ struct FBPDT_Row
 	GENERATED_BODY()
 
 public:
+	// One per column of the table. Rows stored in a table are laid out in
+	// its cell slots instead: columns added after the row was last written
+	// may be missing at the end, dropped ones may still hold a cell (see
+	// FBPDT_Table::GetCell)
 	TArray<FBPDT_Cell> Cells;
 
 public:
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BPDT_Table.h"
+#include "BPDT_ForeignKeyConstraint.h"
+
+/**
+ * Immutable, point-in-time copy of a set of tables.
+ *
+ * Row storage is shared copy-on-write with the live tables, so taking a
+ * snapshot is cheap; the first write to a live table afterwards pays for
+ * detaching its rows. Readers need no locks.
+ */
+struct BPDT_RUNTIME_API FBPDT_DatabaseSnapshot
+{
+	TMap<FString, FBPDT_Table> Tables;
+
+	TArray<FBPDT_ForeignKeyConstraint> ForeignKeys;
+
+	// Snapshots of all tables only: tables removed since the last full save
+	TSet<FString> RemovedTables;
+
+	const FBPDT_Table* FindTable(const FString& TableName) const
+	{
+		return Tables.Find(TableName);
+	}
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
 #include "BPDT_Row.h"
 #include "BPDT_Column.h"
 #include "BPDT_PrimaryKey.h"
@@ -13,6 +14,87 @@ enum class EBPDT_PrimaryKeyMode : uint8
 	Explicit
 };
 
+/**
+ * Reader/writer lock embedded in a table.
+ * Copying or moving a table hands the copy a fresh, unlocked lock.
+ */
+struct FBPDT_TableLock
+{
+	FRWLock RWLock;
+
+	FBPDT_TableLock() = default;
+	FBPDT_TableLock(const FBPDT_TableLock&) {}
+	FBPDT_TableLock& operator=(const FBPDT_TableLock&) { return *this; }
+};
+
+// Rows per row group: unit of dirty tracking and of the v2 data file
+static constexpr int32 BPDT_ROWS_PER_GROUP = 65536;
+
+// Changed rows a table tracks one by one for the write-ahead log; past this
+// the log falls back to the row group stamps
+static constexpr int32 BPDT_MAX_CHANGED_ROWS = 4096;
+
+// Column changes a table keeps for the write-ahead log; past this the log
+// takes the whole table
+static constexpr int32 BPDT_MAX_COLUMN_CHANGES = 64;
+
+// Referenced PK -> positions of the rows whose FK cell holds it
+using FBPDT_ReferenceIndex = TMap<FBPDT_PrimaryKey, TArray<int32>>;
+
+enum class EBPDT_ColumnChange : uint8
+{
+	Add,
+	Drop,
+	Rename
+};
+
+/* A schema change the write-ahead log records without the rows */
+struct FBPDT_ColumnChange
+{
+	EBPDT_ColumnChange Kind = EBPDT_ColumnChange::Add;
+
+	// Position of the column when the change was made
+	int32 ColumnIndex = INDEX_NONE;
+
+	// The column as added, or as it was before a drop or rename
+	FBPDT_Column Column;
+
+	// Rename only
+	FName NewName = NAME_None;
+
+	// Schema version the change produced
+	uint64 SchemaVersion = 0;
+};
+
+/**
+ * Row storage of a table.
+ * Rows live in a dense array (stable positions, chunkable for parallel scans)
+ * and are located by key through Index. Cells are laid out in the table's
+ * slots, not by column; see FBPDT_Table::GetCell.
+ */
+struct FBPDT_RowStore
+{
+	// Keys[i] is the primary key of Rows[i]
+	TArray<FBPDT_PrimaryKey> Keys;
+	TArray<FBPDT_Row> Rows;
+
+	// PK -> position in Rows
+	TMap<FBPDT_PrimaryKey, int32> Index;
+
+	// Cell slot of each FK column -> its reverse index, kept up to date by
+	// every write through the table; see FBPDT_Table::FindReferencingRows
+	TMap<int32, FBPDT_ReferenceIndex> References;
+
+	int32 Add(const FBPDT_PrimaryKey& Key, FBPDT_Row&& Row)
+	{
+		check(!Index.Contains(Key));
+		const int32 RowIndex = Rows.Add(MoveTemp(Row));
+		Keys.Add(Key);
+		Index.Add(Key, RowIndex);
+		return RowIndex;
+	}
+};
+
 USTRUCT()
 struct FBPDT_Table
 {
@@ -25,27 +107,138 @@ public:
 
 	int32 NextSerialID = 1;
 
+	// How the data file's blocks are compressed on save
+	EBPDT_Compression Compression = EBPDT_Compression::None;
+
 	TArray<FBPDT_Column> Columns;
 
 private:
-	TMap<FBPDT_PrimaryKey, FBPDT_Row> Rows;
+	// Shared copy-on-write with snapshots; see MutableRows()
+	TSharedRef<FBPDT_RowStore> RowStore = MakeShared<FBPDT_RowStore>();
+
+	// Changes on every row or schema mutation. Values are unique across all
+	// tables, so equal versions mean the same unmodified table state.
+	uint64 Version = 0;
+
+	// Version of the last change per row group / to the schema. A save that
+	// wrote version V only needs the groups stamped after V.
+	TArray<uint64> RowGroupVersions;
+	uint64 SchemaVersion = 0;
+
+	// Same for the set of columns the data file is laid out by; a rename
+	// changes the schema but not the layout
+	uint64 LayoutVersion = 0;
+
+	// Rows changed since the write-ahead log last took them
+	// (BPDT_WriteAheadLog.h); capped so copies stay cheap
+	TSet<int32> ChangedRows;
+	bool bChangedRowsOverflow = false;
+
+	// Same for schema changes the log can replay by themselves; any other
+	// schema change sets the overflow flag
+	TArray<FBPDT_ColumnChange> ColumnChanges;
+	bool bColumnChangesOverflow = false;
+
+	// Cell per column built from its DefaultData; stands in for the cells rows lack
+	TArray<FBPDT_Cell> DefaultCells;
+
+	// Column -> position of its cell in a row, ascending. Dropped columns
+	// leave their slot behind in the rows until CompactRows.
+	TArray<int32> CellSlots;
+
+	// Cells in a full row, slots of dropped columns included
+	int32 SlotCount = 0;
+
+	mutable FBPDT_TableLock Lock;
 
 public:
 	FORCEINLINE FName GetPKColumnName() const { return PKColumnName; }
 
+	/* See BPDT_TableAccess.h for the locking contract */
+	FORCEINLINE FRWLock& GetLock() const { return Lock.RWLock; }
+
+	FORCEINLINE uint64 GetVersion() const { return Version; }
+	FORCEINLINE uint64 GetSchemaVersion() const { return SchemaVersion; }
+	FORCEINLINE uint64 GetLayoutVersion() const { return LayoutVersion; }
+	uint64 GetRowGroupVersion(int32 Group) const;
+
+	/*
+	 * Hands over the rows changed since the last call and forgets them.
+	 * False if more changed than are tracked; the group stamps tell then.
+	 */
+	bool TakeChangedRows(TArray<int32>& OutRows);
+
+	/*
+	 * Same for column changes, oldest first. False if a schema change that is
+	 * not a column change happened (or too many did); the log then needs the
+	 * whole table.
+	 */
+	bool TakeColumnChanges(TArray<FBPDT_ColumnChange>& OutChanges);
+
 	FBPDT_Table();
 
 	/* Init */
 	void InitSerial();
 
-	/* Row ops */
+	/* Empty table with the given schema; rows then come in through AppendRows */
+	void InitSchema(
+		EBPDT_PrimaryKeyMode InPKMode,
+		FName InPKColumnName,
+		const TArray<FBPDT_Column>& InColumns,
+		int32 InNextSerialID
+	);
+
+	/* Row ops; rows passed in hold one cell per column, in Columns order */
 	FBPDT_Row& InsertRowAsDefault();
+	/* Serial tables assign the PK; explicit tables reject a null or duplicate PK */
 	bool InsertRow(const FBPDT_Row& Row);
 
+	/**
+	 * Bulk load path: takes ownership of the rows and keys them by their stored
+	 * PK cell (serial tables too, so IDs survive a save/load round trip).
+	 * All rows are validated first; on failure nothing is appended.
+	 */
+	bool AppendRows(TArray<FBPDT_Row>&& NewRows);
+
+	/* Log replay: writes a whole row over row RowIndex, re-keying it if its PK changed */
+	bool ReplaceRowAt(int32 RowIndex, FBPDT_Row&& Row);
+
 	const FBPDT_Row* FindRow(const FString& PKValue) const;
+	/* Mutable rows always hold a cell for every column; write FK cells with SetCellAt */
+	FBPDT_Row* FindRowMutable(const FString& PKValue);
 	const FBPDT_Cell* FindCellOnRow(const FString& PKValue, FName ColumnName) const;
 
-	/* Schema ops */
+	/**
+	 * Cell of a row of this table. Stored rows are indexed through the
+	 * table, not by column: columns added after the row was last written are
+	 * not stored on it and read as the column default, and dropped columns
+	 * may still hold a cell that is skipped.
+	 */
+	const FBPDT_Cell& GetCell(const FBPDT_Row& Row, int32 ColumnIndex) const;
+	const FBPDT_Cell& GetCellAt(int32 RowIndex, int32 ColumnIndex) const;
+
+	/* Writes one cell, keeping the reverse index of an FK column current */
+	void SetCellAt(int32 RowIndex, int32 ColumnIndex, const FBPDT_Cell& Cell);
+
+	/*
+	 * Rows whose FK column ColumnIndex references Key, in no particular
+	 * order. False when the column is not an FK column (nothing is indexed).
+	 */
+	bool FindReferencingRows(int32 ColumnIndex, const FBPDT_PrimaryKey& Key, TArray<int32>& OutRowIndices) const;
+
+	/* Every distinct value of an FK column with the rows holding it; false when not indexed */
+	bool ForEachReference(
+		int32 ColumnIndex,
+		TFunctionRef<void(const FBPDT_PrimaryKey& Key, const TArray<int32>& RowIndices)> Func
+	) const;
+
+	/* PK value as GetAllRowPKValues prints it, parsed by the PK column's type */
+	bool TryParsePKFromString(const FString& In, FBPDT_PrimaryKey& OutKey) const;
+
+	/* A stored row as one cell per column, in Columns order */
+	void CopyRow(const FBPDT_Row& Row, FBPDT_Row& OutRow) const;
+
+	/* Schema ops; O(1), existing rows pick the default up through GetCell */
 	bool AddColumn(
 		FName Name,
 		EBPDT_CellType Type,
@@ -53,17 +246,45 @@ public:
 		int32 DefaultSize
 	);
 
+	/*
+	 * O(1) as well: rows keep the dropped cell until CompactRows, and the
+	 * next save writes the file without it. The PK and FK columns cannot be
+	 * dropped.
+	 */
+	bool DropColumn(FName Name);
+
+	/* Metadata only; a save appends to the data file as for row changes */
+	bool RenameColumn(FName OldName, FName NewName);
+
+	/* True while rows still hold cells of dropped columns */
+	bool HasDroppedCells() const { return SlotCount != Columns.Num(); }
+
+	/*
+	 * Removes the cells of dropped columns from every row. Not a change to
+	 * the table's contents, so the version stays; a snapshot sharing the
+	 * rows keeps them as they were. False if there was nothing to reclaim.
+	 */
+	bool CompactRows();
+
+	/*
+	 * PK mode conversions validate first and then cannot fail, so a false
+	 * return leaves the table untouched. Rows stay where they are; only the
+	 * PK cells and the key index are rewritten.
+	 * Serial -> explicit: the new Int column takes over the serial IDs.
+	 */
 	bool ConvertSerialToExplicit(
 		FName NewPKColumnName,
 		EBPDT_CellType Type,
 		const void* DefaultData,
 		int32 DefaultSize
 	);
+	/* Re-keys one row in either PK mode; referencing rows are the caller's */
 	bool ChangePrimaryKey(
 		const FString& OldPKValue,
 		const FString& NewPKValue
 	);
 
+	/* Explicit -> serial: rows are numbered 1..N in storage order */
 	bool ConvertExplicitToSerial();
 	int32 GetRowCount() const;
 	int32 GetColumnIndex(FName ColumnName) const;
@@ -71,10 +292,106 @@ public:
 	const TArray<FBPDT_Column>& GetColumns() const;
 	const FBPDT_Column& GetColumn(int32 Index) const;
 
+	/* Marks a column as referencing ReferencedTable's PK and builds its reverse index */
+	void SetColumnForeignKey(int32 Index, FName ReferencedTable);
+
+	/* The next save rewrites every block of the data file with this codec */
+	void SetCompression(EBPDT_Compression InCompression);
+
 	void ForEachRow(TFunctionRef<void(const FBPDT_PrimaryKey&, const FBPDT_Row&)> Func) const;
-	FBPDT_Row* FindRowMutable(const FBPDT_PrimaryKey& PK){return Rows.Find(PK);}
+	FBPDT_Row* FindRowMutable(const FBPDT_PrimaryKey& PK);
+	bool ContainsKey(const FBPDT_PrimaryKey& PK) const;
+
+	/* Positional access, RowIndex in [0, GetRowCount()) */
+	int32 FindRowIndex(const FString& PKValue) const;
+	const FBPDT_Row& GetRowAt(int32 RowIndex) const;
+	const FBPDT_PrimaryKey& GetKeyAt(int32 RowIndex) const;
+	FBPDT_Row& GetRowAtMutable(int32 RowIndex);
+
+	/* ---------------- Parallel scans ---------------- */
+
+	/* Most pieces any parallel pass is split into, from the worker count */
+	static int32 GetMaxParallelChunks();
+
+	/*
+	 * Splits the rows into contiguous chunks and runs Func(ChunkIndex, Begin, End)
+	 * for each, on the task graph when the table has at least
+	 * BPDT.ParallelRowThreshold rows and inline otherwise. MaxChunks caps the
+	 * split (0 = pick from the worker count). Returns the number of chunks used.
+	 */
+	int32 ParallelForEachChunk(
+		TFunctionRef<void(int32 ChunkIndex, int32 Begin, int32 End)> Func,
+		int32 MaxChunks = 0
+	) const;
+
+	/* Per-row parallel scan; Func must be safe to call concurrently */
+	void ParallelForEachRow(
+		TFunctionRef<void(int32 RowIndex, const FBPDT_PrimaryKey&, const FBPDT_Row&)> Func
+	) const;
+
+	/* Storage positions of the rows matching Pred, in storage order */
+	void ParallelFilter(
+		TFunctionRef<bool(const FBPDT_PrimaryKey&, const FBPDT_Row&)> Pred,
+		TArray<int32>& OutRowIndices
+	) const;
+
+	/*
+	 * Folds every row into one value of type T: each chunk accumulates into its
+	 * own partial (starting from Identity), partials are merged in chunk order.
+	 */
+	template<typename T>
+	T ParallelReduce(
+		const T& Identity,
+		TFunctionRef<void(T& Partial, const FBPDT_PrimaryKey&, const FBPDT_Row&)> Accumulate,
+		TFunctionRef<void(T& Into, const T& Partial)> Merge
+	) const;
+
+	/*
+	 * Copying a table is O(columns): the copy shares row storage with the
+	 * original until either side writes, and the changed rows it carries are
+	 * bounded by BPDT_MAX_CHANGED_ROWS. Snapshots rely on this.
+	 */
+	FBPDT_Table MakeSnapshot() const;
 
 private:
+	/* Detaches row storage from any snapshot still sharing it */
+	FBPDT_RowStore& MutableRows();
+
+	void BumpVersion();
+	void MarkRowChanged(int32 RowIndex);
+	void MarkSchemaChanged();
+	/* Schema change the log records by itself */
+	void MarkColumnChanged(FBPDT_ColumnChange&& Change);
+	/* Forgets what the log has not taken yet; for tables that start out new */
+	void ResetLogTracking();
+
+	/* Key of a row's PK cell; false for a cell that cannot be a key */
+	bool MakeKeyFromPKCell(const FBPDT_Cell& PKCell, FBPDT_PrimaryKey& OutKey) const;
+	void RemoveRowReferences(int32 RowIndex);
+
+	/* After any change to Columns */
+	void RefreshDefaultCells();
+
+	/* One slot per column, in order; rows must be stored that way already */
+	void ResetCellSlots();
+
+	/* Gives a row the default cells it lacks */
+	void MaterializeRow(FBPDT_Row& Row) const;
+
+	/* Lays a row of one cell per column out in slots */
+	void ToStoredRow(FBPDT_Row& Row) const;
+
+	/* Writes a cell of a mutable row by column */
+	void SetCell(FBPDT_Row& Row, int32 ColumnIndex, const FBPDT_Cell& Cell) const;
+
+	/* Reverse indexes; building one is not a change to the table's contents */
+	void BuildReferenceIndex(int32 ColumnIndex);
+	void RebuildReferenceIndexes();
+	void AddRowReferences(int32 RowIndex);
+
+	/* Chunk count ParallelForEachChunk would use for this table */
+	int32 GetChunkCount(int32 MaxChunks) const;
+
 	FBPDT_PrimaryKey MakeSerialKey(int32 Value) const;
 	FBPDT_PrimaryKey MakeExplicitKeyFromRow(const FBPDT_Row& Row) const;
 	FBPDT_PrimaryKey ParsePKFromString(const FString& PKValue) const;
@@ -83,5 +400,35 @@ private:
 
 	int32 GetPKColumnIndex() const;
 	EBPDT_CellType GetPKType() const;
-	bool TryParsePKFromString(const FString& In, FBPDT_PrimaryKey& OutKey) const;
 };
+
+template<typename T>
+T FBPDT_Table::ParallelReduce(
+	const T& Identity,
+	TFunctionRef<void(T& Partial, const FBPDT_PrimaryKey&, const FBPDT_Row&)> Accumulate,
+	TFunctionRef<void(T& Into, const T& Partial)> Merge
+) const
+{
+	TArray<T> Partials;
+	Partials.Init(Identity, GetChunkCount(0));
+
+	const FBPDT_RowStore& Store = *RowStore;
+
+	ParallelForEachChunk(
+		[&](int32 ChunkIndex, int32 Begin, int32 End)
+		{
+			T& Partial = Partials[ChunkIndex];
+			for (int32 i = Begin; i < End; ++i)
+			{
+				Accumulate(Partial, Store.Keys[i], Store.Rows[i]);
+			}
+		}
+	);
+
+	T Result = Identity;
+	for (const T& Partial : Partials)
+	{
+		Merge(Result, Partial);
+	}
+	return Result;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BPDT_Table.h"
+
+/**
+ * Concurrency contract for BPDT tables
+ *
+ *  - The table map (G_BPDT_Tables) and the FK constraint list are guarded by
+ *    one map lock. Looking a table up holds it shared; creating, removing or
+ *    installing a table holds it exclusive.
+ *  - Every FBPDT_Table carries its own reader/writer lock. Reads hold it
+ *    shared, writes (cells, rows, schema, PK) hold it exclusive.
+ *  - Lock order is always map lock -> table lock, and a thread never holds
+ *    two table locks at once. Operations spanning several tables (FK cascades,
+ *    FK application) take the map lock exclusive instead, which waits out
+ *    every open table scope.
+ *  - Locks are not recursive: a UBPDT_TableManager entry point must not call
+ *    another entry point while it holds a scope.
+ *  - Pointers handed out by a scope are only valid while the scope is alive.
+ *  - While the calling thread has a transaction open, scopes resolve to the
+ *    transaction's working copies instead of the live tables.
+ *
+ * Every UBPDT_TableManager entry point follows this contract, so they may be
+ * called from any thread.
+ */
+
+/** Shared access to one table for the lifetime of the scope. */
+class BPDT_RUNTIME_API FBPDT_TableReadScope
+{
+public:
+	explicit FBPDT_TableReadScope(const FString& TableName);
+	~FBPDT_TableReadScope();
+
+	FBPDT_TableReadScope(const FBPDT_TableReadScope&) = delete;
+	FBPDT_TableReadScope& operator=(const FBPDT_TableReadScope&) = delete;
+
+	const FBPDT_Table* Get() const { return Table; }
+	const FBPDT_Table* operator->() const { return Table; }
+	const FBPDT_Table& operator*() const { check(Table); return *Table; }
+	explicit operator bool() const { return Table != nullptr; }
+
+private:
+	const FBPDT_Table* Table = nullptr;
+};
+
+/** Exclusive access to one table for the lifetime of the scope. */
+class BPDT_RUNTIME_API FBPDT_TableWriteScope
+{
+public:
+	explicit FBPDT_TableWriteScope(const FString& TableName);
+	~FBPDT_TableWriteScope();
+
+	FBPDT_TableWriteScope(const FBPDT_TableWriteScope&) = delete;
+	FBPDT_TableWriteScope& operator=(const FBPDT_TableWriteScope&) = delete;
+
+	FBPDT_Table* Get() const { return Table; }
+	FBPDT_Table* operator->() const { return Table; }
+	FBPDT_Table& operator*() const { check(Table); return *Table; }
+	explicit operator bool() const { return Table != nullptr; }
+
+private:
+	FBPDT_Table* Table = nullptr;
+
+	// Used to notify OnTablesChanged when the scope modified the table
+	FString TableName;
+	uint64 StartVersion = 0;
+};
@@ -2,11 +2,23 @@
 
 #include "CoreMinimal.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "Async/Future.h"
 #include "BPDT_Table.h"
+#include "BPDT_TableAccess.h"
+#include "BPDT_Snapshot.h"
+#include "BPDT_CommandBuffer.h"
 #include "BPDT_TableViewTypes.h"
 #include "BPDT_ForeignKeyConstraint.h"
+#include "BPDT_BufferPool.h"
 #include "BPDT_TableManager.generated.h"
 
+/* Names of the tables that changed; fired on the writing thread after its locks are released */
+DECLARE_MULTICAST_DELEGATE_OneParam(FBPDT_OnTablesChanged, const TArray<FString>& /* TableNames */);
+
+/**
+ * Blueprint-facing entry points of the BPDT runtime.
+ * Safe to call from any thread; see BPDT_TableAccess.h for the locking contract.
+ */
 UCLASS()
 class BPDT_RUNTIME_API UBPDT_TableManager : public UBlueprintFunctionLibrary
 {
@@ -47,6 +59,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "BPDT|Save")
 	static bool SaveAllTables();
 
+	/* Per-table block compression of the data file; applies from the next save */
+	UFUNCTION(BlueprintCallable, Category = "BPDT|Save")
+	static bool SetTableCompression(const FString& TableName, EBPDT_Compression Compression);
+
 	UFUNCTION(BlueprintCallable, Category = "BPDT|Load")
 	static bool LoadTable(const FString& TableName);
 
@@ -122,6 +138,23 @@ public:
 		FVector DefaultValue
 	);
 
+	//--------------------Changing Columns--------------------
+
+	/* O(1): rows keep the cells until a background compaction; the PK and FK columns cannot be dropped */
+	UFUNCTION(BlueprintCallable, Category = "BPDT|Table")
+	static bool DropColumn(
+		const FString& TableName,
+		FName ColumnName
+	);
+
+	/* Metadata only; FK constraints naming the column follow it */
+	UFUNCTION(BlueprintCallable, Category = "BPDT|Table")
+	static bool RenameColumn(
+		const FString& TableName,
+		FName OldColumnName,
+		FName NewColumnName
+	);
+
 	//--------------------Setting Cell Values--------------------
 
 	UFUNCTION(BlueprintCallable, Category = "BPDT|Cell")
@@ -274,8 +307,139 @@ public:
 	static bool LoadForeignKeys();
 	static void ApplyForeignKeysToTables();
 
+	/*
+	 * Checks every FK value of the loaded tables against the PKs of its
+	 * referenced table; constraints on tables still on disk are skipped.
+	 * FK columns are checked in parallel, one lookup per distinct value.
+	 * True when nothing is orphaned; the reports list every constraint checked.
+	 */
+	UFUNCTION(BlueprintCallable, Category="BPDT|FK")
+	static bool ValidateForeignKeys(TArray<FBPDT_ForeignKeyReport>& OutReports);
+
+	/* Startup pass, unless BPDT.FKValidation.OnLoad is off */
+	static void ValidateForeignKeysOnLoad();
+
+	//--------------------Deferred Commands--------------------
+
+	/* Applies queued FBPDT_CommandBuffer mutations now (game thread) */
+	UFUNCTION(BlueprintCallable, Category = "BPDT|Commands")
+	static int32 FlushCommandBuffer();
+
+	UFUNCTION(BlueprintCallable, Category = "BPDT|Commands")
+	static void SetCommandBufferFlushPoint(EBPDT_CommandFlushPoint FlushPoint);
+
+	//--------------------Async Save / Load--------------------
+
+	/**
+	 * Non-blocking counterparts of SaveTable/SaveAllTables/LoadTable/LoadAllTables.
+	 * Saves snapshot the tables at call time and serialize on the thread pool.
+	 * Loads read, decode and install every loaded table in one step on the
+	 * thread pool before the future is fulfilled, so waiting on it from the
+	 * game thread is safe; OnTablesChanged fires on that worker.
+	 * Blueprint: see UBPDT_AsyncTableIO.
+	 */
+	static TFuture<bool> SaveTableAsync(const FString& TableName);
+	static TFuture<bool> SaveAllTablesAsync();
+	static TFuture<bool> LoadTableAsync(const FString& TableName);
+	static TFuture<bool> LoadAllTablesAsync();
+
+	//--------------------Bulk import / export--------------------
+
+	/**
+	 * Appends every record of a CSV file (first record names the columns) or
+	 * a JSON array of objects to an existing table, all or nothing. Columns
+	 * the file lacks take their default; serial tables number rows that have
+	 * no PK value. Formats: see BPDT_TextIO.h.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BPDT|IO")
+	static bool ImportTableCSV(const FString& TableName, const FString& FilePath, int32& OutImportedRows);
+
+	UFUNCTION(BlueprintCallable, Category = "BPDT|IO")
+	static bool ImportTableJSON(const FString& TableName, const FString& FilePath, int32& OutImportedRows);
+
+	/* Writes the committed rows, PK column included, in storage order */
+	UFUNCTION(BlueprintCallable, Category = "BPDT|IO")
+	static bool ExportTableCSV(const FString& TableName, const FString& FilePath);
+
+	UFUNCTION(BlueprintCallable, Category = "BPDT|IO")
+	static bool ExportTableJSON(const FString& TableName, const FString& FilePath);
+
+	//--------------------Lazy loading--------------------
+
+	/**
+	 * With BPDT.LazyLoad set, startup only registers the saved tables and each
+	 * one is loaded on first access. This loads the given ones right away,
+	 * e.g. from a game mode before they are needed. Per-map hints go in
+	 * Game.ini: [BPDT.Preload] MapName=TableA,TableB
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BPDT|IO")
+	static void PreloadTables(const TArray<FString>& TableNames);
+
+	/**
+	 * Reads of tables still on disk (column data, row lookups, PK lists) are
+	 * served from pages in a bounded buffer pool (BPDT.BufferPoolMB) instead
+	 * of loading the table; the first write loads it. Also logged by the
+	 * BPDT.BufferPool.Stats console command.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BPDT|IO")
+	static FBPDT_BufferPoolStats GetBufferPoolStats();
+
+	/* Module startup / shutdown; false (and nothing done) unless BPDT.LazyLoad is set or cooked tables are mounted */
+	static bool StartLazyLoading();
+	static void StopLazyLoading();
+
+	/*
+	 * Loads whichever of TableNames are still on disk; false if one failed to.
+	 * A failed table stays registered and is read again after a few seconds.
+	 * Call without holding table locks.
+	 */
+	static bool EnsureTablesLoaded(const TArray<FString>& TableNames);
+
+	//--------------------Transactions--------------------
+
+	/**
+	 * Groups writes on the calling thread. Until commit, every entry point on
+	 * this thread works on private copies of the tables and FK constraints;
+	 * other threads keep seeing the committed state.
+	 * Commit publishes all modified tables under one exclusive map lock and
+	 * fires OnTablesChanged once. It fails (and discards the changes) if any
+	 * table it modified was changed by another thread in the meantime.
+	 * Transactions do not nest. Loads and snapshots bypass them.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BPDT|Transaction")
+	static bool BeginTransaction();
+
+	UFUNCTION(BlueprintCallable, Category = "BPDT|Transaction")
+	static bool CommitTransaction();
+
+	UFUNCTION(BlueprintCallable, Category = "BPDT|Transaction")
+	static bool RollbackTransaction();
+
+	UFUNCTION(BlueprintPure, Category = "BPDT|Transaction")
+	static bool IsInTransaction();
+
+	/* Bind on the game thread; broadcasts may come from any thread */
+	static FBPDT_OnTablesChanged& OnTablesChanged();
+
+	//--------------------Snapshots--------------------
+
+	/**
+	 * Point-in-time view of the committed tables (all tables if empty) plus the FK
+	 * constraints. Costs O(columns) per table; safe to read on any thread
+	 * without locks while the live tables keep changing.
+	 */
+	static TSharedRef<const FBPDT_DatabaseSnapshot> TakeSnapshot(
+		const TArray<FString>& TableNames = TArray<FString>()
+	);
+
 private:
+	// Log replay installs tables like a load
+	friend class FBPDT_WriteAheadLog;
+
+	/* Live state, or the calling thread's transaction copies */
 	static TMap<FString, FBPDT_Table>& GetTables();
+	static TArray<FBPDT_ForeignKeyConstraint>& GetForeignKeys();
+
 	static TArray<FBPDT_ForeignKeyConstraint> ForeignKeys;
 
 	template<typename T>
@@ -295,10 +459,50 @@ private:
 		const T& Value
 	);
 
+	/* Lock-free helpers; caller holds the locks the public wrapper would take */
+	static bool GetPKInfo_NoLock(
+		const FBPDT_Table& Table,
+		FName& OutPKColumnName,
+		EBPDT_CellType& OutPKType,
+		bool& bIsSerial
+	);
+
+	static bool AddExistingForeignKeyConstraint_NoLock(
+		const FString& FKTable,
+		FName FKColumn,
+		const FString& PKTable,
+		FName PKColumn
+	);
+
+	static bool SaveForeignKeys_NoLock();
+
+	/* Save / load plumbing shared by the sync and async paths */
+	static bool WriteSnapshotTables(const FBPDT_DatabaseSnapshot& Snapshot);
+	static bool ReadTables(
+		const TArray<FString>& TableNames,
+		TMap<FString, FBPDT_Table>& OutTables
+	);
+	// Takes the map lock exclusive
+	static void InstallTables(TMap<FString, FBPDT_Table>&& Tables);
+	// Empty name loads every registered table
+	static TFuture<bool> LoadTablesAsync(const FString& TableName);
+
+	// Ticker: drops saved tables idle for BPDT.LazyUnloadSeconds
+	static bool UnloadIdleTables(float DeltaTime);
+
+	// Write-ahead log: visits each committed table under the map read lock
+	// and the table's write lock; nullptr for dropped, skips unloaded tables
+	static void ForEachCommittedTable(
+		const TArray<FString>& TableNames,
+		TFunctionRef<void(const FString&, FBPDT_Table*)> Visitor
+	);
+
+	// Caller holds the map lock exclusive
 	static void CascadePrimaryKeyChange(
 		const FString& ReferencedTableName,
-		const FString& OldPKValue,
-		const FString& NewPKValue
+		const FBPDT_PrimaryKey& OldKey,
+		const FBPDT_PrimaryKey& NewKey,
+		TArray<FString>& OutChangedTables
 	);
 
 };
@@ -306,7 +510,7 @@ private:
 template<typename T>
 inline bool UBPDT_TableManager::AddColumn_Typed(const FString& TableName, FName ColumnName, EBPDT_CellType ExpectedType, const T& DefaultValue)
 {
-	FBPDT_Table* Table = GetTables().Find(TableName);
+	FBPDT_TableWriteScope Table(TableName);
 	if (!Table)
 	{
 		return false;
@@ -359,14 +563,12 @@ bool UBPDT_TableManager::SetCellTyped(
 	const T& Value
 )
 {
-	const FBPDT_Row* RowConst = Table->FindRow(PKValue);
-	if (!RowConst)
+	const int32 RowIndex = Table->FindRowIndex(PKValue);
+	if (RowIndex == INDEX_NONE)
 	{
 		return false;
 	}
 
-	FBPDT_Row* Row = const_cast<FBPDT_Row*>(RowConst);
-
 	const int32 ColIndex = Table->GetColumnIndex(ColumnName);
 	if (ColIndex == INDEX_NONE)
 	{
@@ -379,7 +581,8 @@ bool UBPDT_TableManager::SetCellTyped(
 		return false;
 	}
 
-	Row->SetCell(
+	Table->SetCellAt(
+		RowIndex,
 		ColIndex,
 		FBPDT_Cell(ExpectedType, &Value, sizeof(T))
 	);
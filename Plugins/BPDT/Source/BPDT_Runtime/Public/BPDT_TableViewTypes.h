@@ -28,6 +28,30 @@ struct FBPDT_ColumnView
 	int32 MaxStringLength = 0;
 };
 
+// Result of validating one FK constraint (UBPDT_TableManager::ValidateForeignKeys)
+USTRUCT(BlueprintType)
+struct FBPDT_ForeignKeyReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	FString FKTable;
+
+	UPROPERTY(BlueprintReadOnly)
+	FName FKColumn;
+
+	UPROPERTY(BlueprintReadOnly)
+	FString PKTable;
+
+	// Rows whose FK value is not a PK of PKTable
+	UPROPERTY(BlueprintReadOnly)
+	int32 OrphanCount = 0;
+
+	// First few orphans as "RowPK -> MissingValue"
+	UPROPERTY(BlueprintReadOnly)
+	TArray<FString> OrphanSamples;
+};
+
 USTRUCT(BlueprintType)
 struct FBPDT_TableSchemaView
 {
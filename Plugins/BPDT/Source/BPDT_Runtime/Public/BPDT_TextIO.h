@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BPDT_Table.h"
+
+enum class EBPDT_TextFormat : uint8
+{
+	CSV,
+	JSON
+};
+
+/**
+ * Bulk conversion between table rows and CSV / JSON files.
+ *
+ * Import streams the file in BPDT.TextIO.ChunkMB reads cut at record
+ * boundaries. Each chunk is split again at record boundaries and the pieces
+ * are parsed on the task graph, straight from the UTF-8 bytes into cells.
+ * Export formats batches of rows in parallel and writes them in order.
+ *
+ * CSV (RFC 4180): the first record names the columns. An empty unquoted
+ * field is null, "" is the empty string; vectors are "X Y Z".
+ * JSON: one array of objects keyed by column name; vectors are [X, Y, Z].
+ * Bools are true/false (1/0 accepted). Non-finite floats are written as null.
+ */
+class BPDT_RUNTIME_API FBPDT_TextIO
+{
+public:
+	/**
+	 * Rows in Columns order, in file order. Columns the file lacks take their
+	 * default, except AssignedColumn (INDEX_NONE = none) which stays null for
+	 * the caller to fill, as for serial PKs. Fails, logged, on malformed input
+	 * or a column the table does not have.
+	 */
+	static bool ImportRows(
+		const FString& Path,
+		EBPDT_TextFormat Format,
+		const TArray<FBPDT_Column>& Columns,
+		int32 AssignedColumn,
+		TArray<FBPDT_Row>& OutRows
+	);
+
+	/* Every row of the table, in storage order */
+	static bool ExportRows(
+		const FString& Path,
+		EBPDT_TextFormat Format,
+		const FBPDT_Table& Table
+	);
+};
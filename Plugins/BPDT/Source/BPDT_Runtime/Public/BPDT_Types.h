@@ -14,6 +14,16 @@ enum class EBPDT_CellType : uint8
 	Vector3
 };
 
+/** Block compression of a table's data file (FCompression formats) */
+UENUM(BlueprintType)
+enum class EBPDT_Compression : uint8
+{
+	None,
+	Zlib,
+	LZ4,
+	Oodle
+};
+
 USTRUCT(BlueprintType)
 struct FBPDT_Cell
 {
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+
+#include <atomic>
+
+struct FBPDT_Table;
+struct FBPDT_ColumnChange;
+
+/**
+ * Append-only redo log of table changes, next to the table files.
+ *
+ * Every committed change notification (UBPDT_TableManager::OnTablesChanged)
+ * appends the new images of the rows that changed and the column changes
+ * (FBPDT_ColumnChange) made since; other schema changes, new and reloaded
+ * tables append a full table image, removals a drop record. Records
+ * are buffered and written plus flushed once per BPDT.WAL.FlushInterval
+ * (group commit), so a crash loses at most that window.
+ *
+ * A checkpoint saves every table and deletes the log segments it covers. On
+ * startup the remaining segments are replayed over the loaded tables, through
+ * the table methods that made the changes, and folded into a checkpoint
+ * straight away.
+ *
+ * Lock order: log -> table map -> table. Changes are logged after the
+ * writer released its table locks.
+ */
+class BPDT_RUNTIME_API FBPDT_WriteAheadLog
+{
+public:
+	static FBPDT_WriteAheadLog& Get();
+
+	/* Replays leftover segments, checkpoints, then starts logging */
+	void Startup();
+
+	/* Writes what is buffered and stops logging */
+	void Shutdown();
+
+	/* Logs the current state of the given tables (any thread) */
+	void LogTables(const TArray<FString>& TableNames);
+
+	/* A table was loaded as saved: the log starts from that state (any thread) */
+	void NoteLoadedTable(const FString& TableName, uint64 Version, uint64 SchemaVersion);
+
+	/* Saves every table and drops the covered log segments (game thread) */
+	void Checkpoint();
+
+private:
+	FBPDT_WriteAheadLog() = default;
+
+	// What the log already holds per table
+	struct FLoggedTable
+	{
+		uint64 Version = 0;
+		uint64 SchemaVersion = 0;
+	};
+
+	bool Tick(float DeltaTime);
+
+	/* Rows of the groups stamped after SinceVersion */
+	static void CollectChangedGroups(const FBPDT_Table& Table, uint64 SinceVersion, TArray<int32>& OutRows);
+
+	/* Caller holds Mutex, plus the table's lock where one is passed */
+	void AppendTableImage(const FString& TableName, const FBPDT_Table& Table);
+	void AppendChangedRows(const FString& TableName, const FBPDT_Table& Table, const TArray<int32>& Changed);
+	void AppendColumnChanges(const FString& TableName, const TArray<FBPDT_ColumnChange>& Changes);
+	void AppendDrop(const FString& TableName);
+	void AppendRecord(const TArray<uint8>& Payload);
+
+	/* Writes and flushes the pending batch; takes FileMutex, then Mutex */
+	void FlushPending();
+
+	/* Caller holds FileMutex and Mutex */
+	bool OpenSegment(int32 Index);
+
+	bool Replay();
+
+	static FString GetSegmentPath(int32 Index);
+	static void FindSegments(TArray<int32>& OutIndices);
+	static void DeleteSegmentsUpTo(int32 LastIndex);
+
+	// Guards Pending, Logged and the segment bookkeeping
+	FCriticalSection Mutex;
+
+	// Serializes file writes; taken before Mutex
+	FCriticalSection FileMutex;
+
+	bool bOpen = false;
+
+	TArray<uint8> Pending;
+	TMap<FString, FLoggedTable> Logged;
+
+	TUniquePtr<IFileHandle> File;
+	int32 SegmentIndex = 0;
+	int64 SegmentBytes = 0;
+
+	double LastCheckpointTime = 0.0;
+
+	std::atomic<bool> bFlushInFlight{ false };
+	std::atomic<bool> bCheckpointInFlight{ false };
+
+	FTSTicker::FDelegateHandle TickHandle;
+};